@@ -91,25 +91,15 @@ void PhysObj::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     Sprite::draw(renderer, transform, flags);
 
-    _cmd.init(_globalZOrder);
-    _cmd.func = CC_CALLBACK_0(PhysObj::onDraw, this, transform);
+    // Debug shapes are batched and drawn once per frame by the renderer.
+    auto debugDraw = renderer->getDebugDrawBatch();
 
-    renderer->addCommand(&_cmd);
-
-}
-
-void PhysObj::onDraw(const Mat4 &transform)
-{
-    auto director = Director::sharedDirector();
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, transform);
-        
     // Draw axis-aligned bounding box.
-        
     Color4F color = Color4F(0,0, 0.5, 0.5);
-    Rect& aabb = this->_collider;
-    Rect& bb = this->boundingBox();
-    DrawPrimitives::drawSolidRect(
+    const Rect& aabb = this->_collider;
+    const Rect& bb = this->getBoundingBox();
+    debugDraw->drawSolidRect(
+        transform,
         aabb.origin,
         Vec2(aabb.size.width, aabb.size.height)
         + aabb.origin,
@@ -118,14 +108,13 @@ void PhysObj::onDraw(const Mat4 &transform)
 
     // Anchor Point
     Vec2 anc = this->getAnchorPoint();
-    DrawPrimitives::drawCircle(
+    debugDraw->drawCircle(
+        transform,
         Vec2(anc.x * bb.size.width, anc.y * bb.size.height), 
-        2.f, 0.f, 4, false);
-
+        2.f, 0.f, 4, false, Color4F::WHITE);
 
-    //DrawPrimitives::drawRect(Vec2(0,0), bb.size);
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    //debugDraw->drawRect(transform, Vec2(0,0), bb.size, Color4F::WHITE);
 }
 
 
@@ -40,9 +40,6 @@ private:
     bool isCollidable(uint32_t gid);
     bool isCollidable(const Vec2& coord);
     
-    void onDraw(const Mat4 &transform);
-    CustomCommand _cmd;
-    
 
 public:
     PhysObj();
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __ACTIONS_CCACTION_H__
 
 #include "base/CCRef.h"
+#include "base/CCObjectArena.h"
 #include "math/CCGeometry.h"
 
 NS_CC_BEGIN
@@ -45,6 +46,9 @@ class Node;
 class CC_DLL Action : public Ref, public Clonable
 {
 public:
+    // actions are created and released all the time
+    CC_USE_OBJECT_ARENA()
+
     /// Default tag used for all the actions
     static const int INVALID_TAG = -1;
     /**
@@ -29,7 +29,10 @@
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCDrawNode.h"
 #include "base/CCDirector.h"
+#include "base/ccUtils.h"
+#include "renderer/ccGLStateCache.h"
 
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGroupCommand.h"
@@ -223,8 +226,7 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewTransform(_modelViewTransform);
 
     //Add group command
         
@@ -233,10 +235,16 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
+    // a rectangular stencil is replaced by a scissor box: no stencil draw and no stencil state
+    bool useScissor = checkScissorClipping();
+
     _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
+    if (useScissor)
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisitScissor, this);
+    else
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisit, this);
     renderer->addCommand(&_beforeVisitCmd);
-    if (_alphaThreshold < 1)
+    if (!useScissor && _alphaThreshold < 1)
     {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WINDOWS || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #else
@@ -254,11 +262,14 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 #endif
 
     }
-    _stencil->visit(renderer, _modelViewTransform, flags);
+    if (!useScissor)
+    {
+        _stencil->visit(renderer, _modelViewTransform, flags);
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
-    renderer->addCommand(&_afterDrawStencilCmd);
+        _afterDrawStencilCmd.init(_globalZOrder);
+        _afterDrawStencilCmd.func = CC_CALLBACK_0(ClippingNode::onAfterDrawStencil, this);
+        renderer->addCommand(&_afterDrawStencilCmd);
+    }
 
     int i = 0;
     
@@ -287,12 +298,40 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     }
 
     _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
+    if (useScissor)
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisitScissor, this);
+    else
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisit, this);
     renderer->addCommand(&_afterVisitCmd);
 
     renderer->popGroup();
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewTransform();
+}
+
+bool ClippingNode::checkScissorClipping()
+{
+    // the alpha threshold and inverted clipping need the stencil buffer
+    if (_alphaThreshold < 1 || _inverted)
+        return false;
+
+    auto drawNode = dynamic_cast<DrawNode*>(_stencil);
+    if (!drawNode || !drawNode->isVisible() || !drawNode->getChildren().empty() || !drawNode->isAxisAlignedRect(&_scissorRect))
+        return false;
+
+    _scissorTransform = _modelViewTransform * drawNode->getNodeToParentTransform();
+    return utils::isAxisAligned(_scissorTransform);
+}
+
+void ClippingNode::onBeforeVisitScissor()
+{
+    Rect rect = utils::getWindowRect(_scissorTransform, _scissorRect);
+    GL::pushScissor((GLint)rect.origin.x, (GLint)rect.origin.y, (GLsizei)rect.size.width, (GLsizei)rect.size.height);
+}
+
+void ClippingNode::onAfterVisitScissor()
+{
+    GL::popScissor();
 }
 
 Node* ClippingNode::getStencil() const
@@ -96,6 +96,7 @@ public:
      */
     virtual void onExit() override;
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
     
 CC_CONSTRUCTOR_ACCESS:
     ClippingNode();
@@ -129,6 +130,14 @@ protected:
     void onAfterDrawStencil();
     void onAfterVisit();
 
+    // returns true, and the scissor rect and transform, when the stencil is an axis aligned rectangle
+    bool checkScissorClipping();
+    void onBeforeVisitScissor();
+    void onAfterVisitScissor();
+
+    Rect _scissorRect;
+    Mat4 _scissorTransform;
+
     GLboolean _currentStencilEnabled;
     GLuint _currentStencilWriteMask;
     GLenum _currentStencilFunc;
@@ -108,6 +108,7 @@ DrawNode::DrawNode()
 , _bufferCount(0)
 , _buffer(nullptr)
 , _dirty(false)
+, _rectBufferCount(-1)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 }
@@ -350,6 +351,8 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 {
     CCASSERT(count >= 0, "invalid count value");
 
+    bool wasEmpty = (_bufferCount == 0);
+
     struct ExtrudeVerts {Vec2 offset, n;};
 	struct ExtrudeVerts* extrude = (struct ExtrudeVerts*)malloc(sizeof(struct ExtrudeVerts)*count);
 	memset(extrude, 0, sizeof(struct ExtrudeVerts)*count);
@@ -452,6 +455,40 @@ void DrawNode::drawPolygon(Vec2 *verts, int count, const Color4F &fillColor, flo
 	_dirty = true;
 
     free(extrude);
+
+    if (wasEmpty && count == 4)
+    {
+        // every edge must be either horizontal or vertical
+        bool axisAligned = true;
+        Vec2 minVert = verts[0];
+        Vec2 maxVert = verts[0];
+        for (int i = 0; i < count; i++)
+        {
+            const Vec2& v0 = verts[i];
+            const Vec2& v1 = verts[(i+1)%count];
+            axisAligned = axisAligned && ((v0.x == v1.x) != (v0.y == v1.y));
+            minVert.x = std::min(minVert.x, v0.x);
+            minVert.y = std::min(minVert.y, v0.y);
+            maxVert.x = std::max(maxVert.x, v0.x);
+            maxVert.y = std::max(maxVert.y, v0.y);
+        }
+        if (axisAligned)
+        {
+            float border = outline ? borderWidth : 0;
+            _rect.setRect(minVert.x - border, minVert.y - border,
+                          maxVert.x - minVert.x + border * 2, maxVert.y - minVert.y + border * 2);
+            _rectBufferCount = _bufferCount;
+        }
+    }
+}
+
+bool DrawNode::isAxisAlignedRect(Rect* rect) const
+{
+    if (_bufferCount == 0 || _bufferCount != _rectBufferCount)
+        return false;
+
+    *rect = _rect;
+    return true;
 }
 
 void DrawNode::drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, const Color4F &color)
@@ -537,6 +574,7 @@ void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const
 void DrawNode::clear()
 {
     _bufferCount = 0;
+    _rectBufferCount = -1;
     _dirty = true;
 }
 
@@ -75,6 +75,13 @@ public:
     
     /** Clear the geometry in the node's buffer. */
     void clear();
+
+    /** Returns true if the only thing drawn is one axis aligned rectangle, drawn with drawPolygon().
+     The area it covers, border included, is returned in rect.
+     ClippingNode uses it to clip with a scissor box instead of the stencil buffer.
+     @since v3.3
+     */
+    bool isAxisAlignedRect(Rect* rect) const;
     /**
     * @js NA
     * @lua NA
@@ -114,6 +121,10 @@ protected:
 
     bool        _dirty;
 
+    // bounds of the rectangle drawn first, valid while _bufferCount == _rectBufferCount
+    Rect        _rect;
+    GLsizei     _rectBufferCount;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DrawNode);
 };
@@ -1088,8 +1088,7 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
     
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewTransform(_modelViewTransform);
     
 
     if (_textSprite)
@@ -1101,7 +1100,7 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         draw(renderer, _modelViewTransform, flags);
     }
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewTransform();
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -264,6 +264,7 @@ public:
     virtual Rect getBoundingBox() const override;
 
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
     CC_DEPRECATED_ATTRIBUTE static Label* create(const std::string& text, const std::string& font, float fontSize,
@@ -30,7 +30,7 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <string>
-#include <regex>
+#include <unordered_map>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -45,8 +45,12 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
 #include "2d/CCComponentContainer.h"
+#include "2d/CCStaticBatchNode.h"
+#include "2d/CCSpatialIndexNode.h"
+#include "2d/CCNodePath.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
@@ -64,6 +68,38 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+struct Node::ChildIndex
+{
+    // unnamed and untagged children aren't indexed
+    std::unordered_multimap<int, Node*> tags;
+    std::unordered_multimap<size_t, Node*> names;
+};
+
+// true if the matrix maps the XY plane with a 2D affine transform, and only scales and translates Z
+static inline bool isAffine2D(const Mat4& t)
+{
+    const float* m = t.m;
+    return m[2] == 0 && m[3] == 0 && m[6] == 0 && m[7] == 0 && m[8] == 0 && m[9] == 0 && m[11] == 0 && m[15] == 1;
+}
+
+// dst = a * b for two isAffine2D() matrices, with 12 multiplications instead of 64
+static inline void multiplyAffine2D(const Mat4& a, const Mat4& b, Mat4* dst)
+{
+    const float* m1 = a.m;
+    const float* m2 = b.m;
+    float* m = dst->m;
+    m[0] = m1[0] * m2[0] + m1[4] * m2[1];
+    m[1] = m1[1] * m2[0] + m1[5] * m2[1];
+    m[4] = m1[0] * m2[4] + m1[4] * m2[5];
+    m[5] = m1[1] * m2[4] + m1[5] * m2[5];
+    m[10] = m1[10] * m2[10];
+    m[12] = m1[0] * m2[12] + m1[4] * m2[13] + m1[12];
+    m[13] = m1[1] * m2[12] + m1[5] * m2[13] + m1[13];
+    m[14] = m1[10] * m2[14] + m1[14];
+    m[2] = m[3] = m[6] = m[7] = m[8] = m[9] = m[11] = 0;
+    m[15] = 1;
+}
+
 bool nodeComparisonLess(Node* n1, Node* n2)
 {
     return( n1->getLocalZOrder() < n2->getLocalZOrder() ||
@@ -93,6 +129,7 @@ Node::Node(void)
 , _transformDirty(true)
 , _inverseDirty(true)
 , _transformUpdated(true)
+, _has3DTransform(false)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrder(0)
@@ -109,6 +146,7 @@ Node::Node(void)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _reorderPending(false)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -128,6 +166,13 @@ Node::Node(void)
 , _usingNormalizedPosition(false)
 , _name("")
 , _hashOfName(0)
+, _childIndex(nullptr)
+, _indexedByParent(false)
+, _staticBatchNode(nullptr)
+, _spatialIndexNode(nullptr)
+, _parallelVisitEnabled(false)
+, _subtreeParallelVisitSupported(true)
+, _parallelVisitSupportDirty(false)
 {
     // set default scheduler and actionManager
     Director *director = Director::getInstance();
@@ -171,6 +216,7 @@ Node::~Node()
     removeAllComponents();
     
     CC_SAFE_DELETE(_componentContainer);
+    CC_SAFE_DELETE(_childIndex);
     
 #if CC_USE_PHYSICS
     setPhysicsBody(nullptr);
@@ -214,6 +260,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 float Node::getSkewY() const
@@ -235,6 +282,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 
@@ -283,6 +331,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 
 #if CC_USE_PHYSICS
     if (!_physicsBody || !_physicsBody->_rotationResetTag)
@@ -305,6 +354,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -342,6 +392,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 float Node::getRotationSkewY() const
@@ -363,6 +414,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 /// scale getter
@@ -380,6 +432,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
     
 #if CC_USE_PHYSICS
     updatePhysicsBodyTransform(getScene());
@@ -401,6 +454,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
     
 #if CC_USE_PHYSICS
     updatePhysicsBodyTransform(getScene());
@@ -415,6 +469,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
     
 #if CC_USE_PHYSICS
     updatePhysicsBodyTransform(getScene());
@@ -442,6 +497,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 /// scaleY getter
@@ -458,6 +514,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
     
 #if CC_USE_PHYSICS
     updatePhysicsBodyTransform(getScene());
@@ -479,6 +536,7 @@ void Node::setPosition(const Vec2& position)
     
     _position = position;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
     _usingNormalizedPosition = false;
 
 #if CC_USE_PHYSICS
@@ -546,6 +604,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 
     _positionZ = positionZ;
 
@@ -569,6 +628,7 @@ void Node::setNormalizedPosition(const Vec2& position)
     _normalizedPosition = position;
     _usingNormalizedPosition = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -589,6 +649,7 @@ void Node::setVisible(bool visible)
     {
         _visible = visible;
         if(_visible) _transformUpdated = _transformDirty = _inverseDirty = true;
+        markRenderCacheDirty();
     }
 }
 
@@ -618,6 +679,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markRenderCacheDirty();
     }
 }
 
@@ -635,6 +697,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints = Vec2(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y );
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        markRenderCacheDirty();
     }
 }
 
@@ -647,6 +710,22 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    if (parent)
+    {
+        parent->markRenderCacheDirty();
+    }
+    else if (_staticBatchNode)
+    {
+        // a detached node must not keep a weak reference to the batch that baked it
+        markRenderCacheDirty();
+        StaticBatchNode::setStaticBatchNode(this, nullptr);
+    }
+
+    if (_spatialIndexNode && _spatialIndexNode != parent)
+    {
+        _spatialIndexNode->removeFromIndex(this);
+    }
+
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
 }
@@ -663,6 +742,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
 		_ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        markRenderCacheDirty();
 	}
 }
 
@@ -675,7 +755,15 @@ int Node::getTag() const
 /// tag setter
 void Node::setTag(int tag)
 {
+    // protected children of a ProtectedNode have a parent but are not in its index
+    bool indexed = _indexedByParent;
+    if (indexed)
+        _parent->removeFromChildIndex(this);
+
     _tag = tag ;
+
+    if (indexed)
+        _parent->addToChildIndex(this);
 }
 
 std::string Node::getName() const
@@ -685,9 +773,17 @@ std::string Node::getName() const
 
 void Node::setName(const std::string& name)
 {
+    // protected children of a ProtectedNode have a parent but are not in its index
+    bool indexed = _indexedByParent;
+    if (indexed)
+        _parent->removeFromChildIndex(this);
+
     _name = name;
     std::hash<std::string> h;
     _hashOfName = h(name);
+
+    if (indexed)
+        _parent->addToChildIndex(this);
 }
 
 /// userData setter
@@ -725,6 +821,7 @@ void Node::setGLProgramState(cocos2d::GLProgramState *glProgramState)
         CC_SAFE_RELEASE(_glProgramState);
         _glProgramState = glProgramState;
         CC_SAFE_RETAIN(_glProgramState);
+        markRenderCacheDirty();
     }
 }
 
@@ -735,9 +832,18 @@ void Node::setGLProgram(GLProgram *glProgram)
         CC_SAFE_RELEASE(_glProgramState);
         _glProgramState = GLProgramState::getOrCreateWithGLProgram(glProgram);
         _glProgramState->retain();
+        markRenderCacheDirty();
     }
 }
 
+void Node::invalidateRenderCache()
+{
+    if (_staticBatchNode)
+        _staticBatchNode->setBakeDirty();
+    if (_spatialIndexNode)
+        _spatialIndexNode->setChildDirty(this);
+}
+
 GLProgram * Node::getGLProgram() const
 {
     return _glProgramState ? _glProgramState->getGLProgram() : nullptr;
@@ -808,6 +914,16 @@ Node* Node::getChildByTag(int tag) const
 {
     CCASSERT( tag != Node::INVALID_TAG, "Invalid tag");
 
+    if (_childIndex)
+    {
+        auto range = _childIndex->tags.equal_range(tag);
+        if (range.first == range.second)
+            return nullptr;
+        if (std::next(range.first) == range.second)
+            return range.first->second;
+        // several children have the tag: return the first one
+    }
+
     for (auto& child : _children)
     {
         if(child && child->_tag == tag)
@@ -822,6 +938,10 @@ Node* Node::getChildByName(const std::string& name) const
     
     std::hash<std::string> h;
     size_t hash = h(name);
+
+    Node* found = nullptr;
+    if (lookupChildByName(name, hash, &found))
+        return found;
     
     for (const auto& child : _children)
     {
@@ -836,115 +956,93 @@ void Node::enumerateChildren(const std::string &name, std::function<bool (Node *
 {
     CCASSERT(name.length() != 0, "Invalid name");
     CCASSERT(callback != nullptr, "Invalid callback function");
-    
-    size_t length = name.length();
-    
-    size_t subStrStartPos = 0;  // sub string start index
-    size_t subStrlength = length; // sub string length
-    
-    // Starts with '//'?
-    bool searchRecursively = false;
-    if (length > 2 && name[0] == '/' && name[1] == '/')
-    {
-        searchRecursively = true;
-        subStrStartPos = 2;
-        subStrlength -= 2;
-    }
-    
-    // End with '/..'?
-    bool searchFromParent = false;
-    if (length > 3 &&
-        name[length-3] == '/' &&
-        name[length-2] == '.' &&
-        name[length-1] == '.')
-    {
-        searchFromParent = true;
-        subStrlength -= 3;
-    }
-    
-    // Remove '//', '/..' if exist
-    std::string newName = name.substr(subStrStartPos, subStrlength);
 
-    if (searchFromParent)
-    {
-        newName.insert(0, "[[:alnum:]]+/");
-    }
-    
-    
-    if (searchRecursively)
+    NodePath(name).enumerate(this, callback);
+}
+
+void Node::enumerateChildren(const NodePath& path, const std::function<bool (Node *)>& callback) const
+{
+    CCASSERT(callback != nullptr, "Invalid callback function");
+
+    path.enumerate(this, callback);
+}
+
+void Node::setChildIndexEnabled(bool enabled)
+{
+    if (enabled == (_childIndex != nullptr))
+        return;
+
+    if (enabled)
     {
-        // name is '//xxx'
-        doEnumerateRecursive(this, newName, callback);
+        _childIndex = new ChildIndex();
+        for (const auto& child : _children)
+        {
+            addToChildIndex(child);
+        }
     }
     else
     {
-        // name is xxx
-        doEnumerate(newName, callback);
+        CC_SAFE_DELETE(_childIndex);
+        for (const auto& child : _children)
+        {
+            child->_indexedByParent = false;
+        }
     }
 }
 
-bool Node::doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const
+void Node::addToChildIndex(Node* child)
 {
-    bool ret =false;
-    
-    if (node->doEnumerate(name, callback))
+    child->_indexedByParent = true;
+    if (child->_tag != INVALID_TAG)
+        _childIndex->tags.insert(std::make_pair(child->_tag, child));
+    if (!child->_name.empty())
+        _childIndex->names.insert(std::make_pair(child->_hashOfName, child));
+}
+
+void Node::removeFromChildIndex(Node* child)
+{
+    child->_indexedByParent = false;
+    auto tags = _childIndex->tags.equal_range(child->_tag);
+    for (auto it = tags.first; it != tags.second; ++it)
     {
-        // search itself
-        ret = true;
+        if (it->second == child)
+        {
+            _childIndex->tags.erase(it);
+            break;
+        }
     }
-    else
+
+    auto names = _childIndex->names.equal_range(child->_hashOfName);
+    for (auto it = names.first; it != names.second; ++it)
     {
-        // search its children
-        for (const auto& child : node->getChildren())
+        if (it->second == child)
         {
-            if (doEnumerateRecursive(child, name, callback))
-            {
-                ret = true;
-                break;
-            }
+            _childIndex->names.erase(it);
+            break;
         }
     }
-    
-    return ret;
 }
 
-bool Node::doEnumerate(std::string name, std::function<bool (Node *)> callback) const
+bool Node::lookupChildByName(const std::string& name, size_t hash, Node** child) const
 {
-    // name may be xxx/yyy, should find its parent
-    size_t pos = name.find('/');
-    std::string searchName = name;
-    bool needRecursive = false;
-    if (pos != name.npos)
-    {
-        searchName = name.substr(0, pos);
-        name.erase(0, pos+1);
-        needRecursive = true;
-    }
-    
-    bool ret = false;
-    for (const auto& child : _children)
+    if (_childIndex == nullptr || name.empty())
+        return false;
+
+    Node* found = nullptr;
+    auto range = _childIndex->names.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
     {
-        if (std::regex_match(child->_name, std::regex(searchName)))
+        if (it->second->_name == name)
         {
-            if (!needRecursive)
-            {
-                // terminate enumeration if callback return true
-                if (callback(child))
-                {
-                    ret = true;
-                    break;
-                }
-            }
-            else
-            {
-                ret = child->doEnumerate(name, callback);
-                if (ret)
-                    break;
-            }
+            // the first one depends on the order of the children
+            if (found)
+                return false;
+            found = it->second;
         }
     }
-    
-    return ret;
+
+    *child = found;
+    return true;
 }
 
 /* "add" logic MUST only be on this method
@@ -983,6 +1081,9 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
     
     child->setParent(this);
     child->setOrderOfArrival(s_globalOrderOfArrival++);
+
+    if (_childIndex)
+        addToChildIndex(child);
     
 #if CC_USE_PHYSICS
     // Recursive add children with which have physics body.
@@ -1120,9 +1221,19 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
         }
         // set parent nil at the end
         child->setParent(nullptr);
+        child->_reorderPending = false;
+        child->_indexedByParent = false;
     }
     
     _children.clear();
+    _reorderedChildren.clear();
+    invalidateParallelVisitSupport();
+
+    if (_childIndex)
+    {
+        _childIndex->tags.clear();
+        _childIndex->names.clear();
+    }
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1154,7 +1265,17 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     // set parent nil at the end
     child->setParent(nullptr);
 
+    if (_childIndex)
+        removeFromChildIndex(child);
+
+    if (child->_reorderPending)
+    {
+        child->_reorderPending = false;
+        _reorderedChildren.erase(std::find(_reorderedChildren.begin(), _reorderedChildren.end(), child));
+    }
+
     _children.erase(childIndex);
+    invalidateParallelVisitSupport();
 }
 
 
@@ -1165,6 +1286,8 @@ void Node::insertChild(Node* child, int z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
+    markChildReordered(child);
+    invalidateParallelVisitSupport();
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -1173,16 +1296,80 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_setLocalZOrder(zOrder);
+    markChildReordered(child);
+    markRenderCacheDirty();
+    invalidateParallelVisitSupport();
+}
+
+void Node::markChildReordered(Node* child)
+{
+    if (!child->_reorderPending)
+    {
+        child->_reorderPending = true;
+        _reorderedChildren.push_back(child);
+    }
 }
 
 void Node::sortAllChildren()
 {
     if( _reorderChildDirty ) {
-        std::sort( std::begin(_children), std::end(_children), nodeComparisonLess );
+        sortChildrenIncrementally();
         _reorderChildDirty = false;
     }
 }
 
+void Node::sortChildrenIncrementally()
+{
+    ssize_t count = _children.size();
+    ssize_t movedCount = _reorderedChildren.size();
+
+    // take the reordered children out: the others keep their order of the last sort.
+    // The pointers are only moved around, so the Vector doesn't need to retain them again
+    auto children = _children.begin();
+    ssize_t othersCount = 0;
+    bool othersSorted = true;
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        Node* child = children[i];
+        if (child->_reorderPending)
+            continue;
+
+        // children reordered without reorderChild(), by a subclass, need a full sort
+        if (othersCount > 0 && nodeComparisonLess(child, children[othersCount - 1]))
+            othersSorted = false;
+        children[othersCount++] = child;
+    }
+    CCASSERT(othersCount + movedCount == count, "reordered children must be children of the node");
+
+    for (ssize_t i = 0; i < movedCount; ++i)
+    {
+        _reorderedChildren[i]->_reorderPending = false;
+        children[othersCount + i] = _reorderedChildren[i];
+    }
+
+    if (!othersSorted)
+    {
+        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+    }
+    else if (movedCount > 0)
+    {
+        // sort the few reordered children, then merge them with the others from the end: O(n + k log k)
+        std::sort(std::begin(_reorderedChildren), std::end(_reorderedChildren), nodeComparisonLess);
+
+        ssize_t other = othersCount - 1;
+        ssize_t moved = movedCount - 1;
+        for (ssize_t i = count - 1; moved >= 0; --i)
+        {
+            if (other >= 0 && nodeComparisonLess(_reorderedChildren[moved], children[other]))
+                children[i] = children[other--];
+            else
+                children[i] = _reorderedChildren[moved--];
+        }
+    }
+
+    _reorderedChildren.clear();
+}
+
 void Node::draw()
 {
     auto renderer = Director::getInstance()->getRenderer();
@@ -1236,37 +1423,61 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
+    // The stack is not thread safe, so it is not updated in parallel visits
+    bool useMatrixStack = !(flags & FLAGS_PARALLEL_VISIT);
     Director* director = Director::getInstance();
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    if (useMatrixStack)
+    {
+        director->pushModelViewTransform(_modelViewTransform);
+    }
 
     int i = 0;
 
     if(!_children.empty())
     {
         sortAllChildren();
-        // draw children zOrder < 0
-        for( ; i < _children.size(); i++ )
-        {
-            auto node = _children.at(i);
 
-            if ( node && node->_localZOrder < 0 )
-                node->visit(renderer, _modelViewTransform, flags);
-            else
-                break;
+        if (_parallelVisitEnabled && isSubtreeParallelVisitSupported())
+        {
+            // draw children zOrder < 0
+            for( ; i < _children.size(); i++ )
+            {
+                if (_children.at(i)->_localZOrder >= 0)
+                    break;
+            }
+            visitChildrenInParallel(renderer, 0, i, flags);
+            // self draw
+            this->draw(renderer, _modelViewTransform, flags);
+            visitChildrenInParallel(renderer, i, _children.size(), flags);
         }
-        // self draw
-        this->draw(renderer, _modelViewTransform, flags);
+        else
+        {
+            // draw children zOrder < 0
+            for( ; i < _children.size(); i++ )
+            {
+                auto node = _children.at(i);
+
+                if ( node && node->_localZOrder < 0 )
+                    node->visit(renderer, _modelViewTransform, flags);
+                else
+                    break;
+            }
+            // self draw
+            this->draw(renderer, _modelViewTransform, flags);
 
-        for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+            for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
+                (*it)->visit(renderer, _modelViewTransform, flags);
+        }
     }
     else
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+    {
+        director->popModelViewTransform();
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1274,10 +1485,52 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildrenInParallel(Renderer* renderer, ssize_t first, ssize_t last, uint32_t flags)
+{
+    if (first >= last)
+        return;
+
+    uint32_t childFlags = flags | FLAGS_PARALLEL_VISIT;
+    renderer->visitInParallel(last - first, [&](ssize_t sliceFirst, ssize_t sliceLast){
+        for (ssize_t j = first + sliceFirst; j < first + sliceLast; ++j)
+            _children.at(j)->visit(renderer, _modelViewTransform, childFlags);
+    });
+}
+
+bool Node::isSubtreeParallelVisitSupported()
+{
+    if (_parallelVisitSupportDirty)
+    {
+        // all the dirty children are refreshed, a clean node must not have dirty descendants
+        _subtreeParallelVisitSupported = true;
+        for (const auto& child : _children)
+        {
+            bool supported = child->isSubtreeParallelVisitSupported();
+            if (!supported || !child->isParallelVisitSupported())
+                _subtreeParallelVisitSupported = false;
+        }
+        _parallelVisitSupportDirty = false;
+    }
+    return _subtreeParallelVisitSupported;
+}
+
+void Node::invalidateParallelVisitSupport()
+{
+    // the ancestors of a dirty node are dirty already
+    for (Node* node = this; node && !node->_parallelVisitSupportDirty; node = node->_parent)
+    {
+        node->_parallelVisitSupportDirty = true;
+    }
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
-    Mat4 ret = this->getNodeToParentTransform();
-    ret  = parentTransform * ret;
+    const Mat4& localTransform = this->getNodeToParentTransform();
+    Mat4 ret;
+    if (!_has3DTransform && isAffine2D(parentTransform))
+        multiplyAffine2D(parentTransform, localTransform, &ret);
+    else
+        ret = parentTransform * localTransform;
     return ret;
 }
 
@@ -1636,28 +1889,32 @@ const Mat4& Node::getNodeToParentTransform() const
         
         _transform.set(mat);
 
-        if(!_ignoreAnchorPointForPosition)
+        // the anchor point translations cancel each other without a rotation around X or Y
+        if (_rotationX || _rotationY)
         {
-            _transform.translate(anchorPoint.x, anchorPoint.y, 0);
-        }
-        
-        // XXX
-        // FIX ME: Expensive operation.
-        // FIX ME: It should be done together with the rotationZ
-        if(_rotationY) {
-            Mat4 rotY;
-            Mat4::createRotationY(CC_DEGREES_TO_RADIANS(_rotationY), &rotY);
-            _transform = _transform * rotY;
-        }
-        if(_rotationX) {
-            Mat4 rotX;
-            Mat4::createRotationX(CC_DEGREES_TO_RADIANS(_rotationX), &rotX);
-            _transform = _transform * rotX;
-        }
+            if(!_ignoreAnchorPointForPosition)
+            {
+                _transform.translate(anchorPoint.x, anchorPoint.y, 0);
+            }
 
-        if(!_ignoreAnchorPointForPosition)
-        {
-            _transform.translate(-anchorPoint.x, -anchorPoint.y, 0);
+            // XXX
+            // FIX ME: Expensive operation.
+            // FIX ME: It should be done together with the rotationZ
+            if(_rotationY) {
+                Mat4 rotY;
+                Mat4::createRotationY(CC_DEGREES_TO_RADIANS(_rotationY), &rotY);
+                _transform = _transform * rotY;
+            }
+            if(_rotationX) {
+                Mat4 rotX;
+                Mat4::createRotationX(CC_DEGREES_TO_RADIANS(_rotationX), &rotX);
+                _transform = _transform * rotX;
+            }
+
+            if(!_ignoreAnchorPointForPosition)
+            {
+                _transform.translate(-anchorPoint.x, -anchorPoint.y, 0);
+            }
         }
         
         // XXX: Try to inline skew
@@ -1686,17 +1943,26 @@ const Mat4& Node::getNodeToParentTransform() const
             _transform = _transform * _additionalTransform;
         }
 
+        _has3DTransform = _rotationX || _rotationY || (_useAdditionalTransform && !isAffine2D(_additionalTransform));
         _transformDirty = false;
     }
 
     return _transform;
 }
 
+bool Node::has3DTransform() const
+{
+    getNodeToParentTransform();
+    return _has3DTransform;
+}
+
 void Node::setNodeToParentTransform(const Mat4& transform)
 {
     _transform = transform;
+    _has3DTransform = !isAffine2D(transform);
     _transformDirty = false;
     _transformUpdated = true;
+    markRenderCacheDirty();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1715,6 +1981,7 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    markRenderCacheDirty();
 }
 
 
@@ -1751,10 +2018,22 @@ AffineTransform Node::getNodeToWorldAffineTransform() const
 Mat4 Node::getNodeToWorldTransform() const
 {
     Mat4 t = this->getNodeToParentTransform();
+    bool is2D = !_has3DTransform;
 
     for (Node *p = _parent; p != nullptr; p = p->getParent())
     {
-        t = p->getNodeToParentTransform() * t;
+        const Mat4& parentTransform = p->getNodeToParentTransform();
+        if (is2D && !p->_has3DTransform)
+        {
+            Mat4 ret;
+            multiplyAffine2D(parentTransform, t, &ret);
+            t = ret;
+        }
+        else
+        {
+            is2D = false;
+            t = parentTransform * t;
+        }
     }
 
     return t;
@@ -2031,6 +2310,7 @@ void Node::updateDisplayedOpacity(GLubyte parentOpacity)
 {
 	_displayedOpacity = _realOpacity * parentOpacity/255.0;
     updateColor();
+    markRenderCacheDirty();
     
     if (_cascadeOpacityEnabled)
     {
@@ -2108,6 +2388,7 @@ void Node::updateDisplayedColor(const Color3B& parentColor)
 	_displayedColor.g = _realColor.g * parentColor.g/255.0;
 	_displayedColor.b = _realColor.b * parentColor.b/255.0;
     updateColor();
+    markRenderCacheDirty();
     
     if (_cascadeColorEnabled)
     {
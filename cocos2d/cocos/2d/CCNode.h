@@ -54,6 +54,9 @@ class Scene;
 class Renderer;
 class GLProgram;
 class GLProgramState;
+class StaticBatchNode;
+class SpatialIndexNode;
+class NodePath;
 #if CC_USE_PHYSICS
 class PhysicsBody;
 #endif
@@ -110,6 +113,8 @@ public:
     enum {
         FLAGS_TRANSFORM_DIRTY = (1 << 0),
         FLAGS_CONTENT_SIZE_DIRTY = (1 << 1),
+        FLAGS_SKIP_CULLING = (1 << 2),
+        FLAGS_PARALLEL_VISIT = (1 << 3),
 
         FLAGS_DIRTY_MASK = (FLAGS_TRANSFORM_DIRTY | FLAGS_CONTENT_SIZE_DIRTY),
     };
@@ -749,6 +754,24 @@ public:
      * @since v3.2
      */
     virtual void enumerateChildren(const std::string &name, std::function<bool(Node* node)> callback) const;
+    /**
+     * Same as enumerateChildren() with a string, with a path that was parsed once.
+     * Keep the NodePath to run the same search every frame.
+     *
+     * @since v3.3
+     */
+    void enumerateChildren(const NodePath& path, const std::function<bool(Node* node)>& callback) const;
+    /**
+     * Enables an index of the children by tag and by name.
+     *
+     * getChildByTag(), getChildByName() and the names of a NodePath are then looked up in constant time
+     * instead of comparing every child. The index is kept up to date when children are added with addChild(),
+     * removed, renamed or retagged. Enable it on the nodes that have many children.
+     *
+     * @since v3.3
+     */
+    void setChildIndexEnabled(bool enabled);
+    bool isChildIndexEnabled() const { return _childIndex != nullptr; }
     /**
      * Returns the array of the node's children
      *
@@ -1063,6 +1086,28 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the children of this node are visited from several threads.
+     * Useful for nodes with thousands of sprites. Disabled by default.
+     *
+     * The children are visited in contiguous slices, and the resulting render queue is the same as the one of a serial visit.
+     * Inside these subtrees the deprecated Director matrix stack is not updated, and draw() must not touch shared state.
+     * The children are visited serially when a node of their subtrees returns false from isParallelVisitSupported().
+     *
+     * @see CC_PARALLEL_VISIT_MAX_THREADS, CC_PARALLEL_VISIT_MIN_NODES_PER_THREAD
+     * @since v3.3
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    /** Returns whether the children of this node are visited from several threads */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+    /**
+     * Returns whether this node can be visited from a worker thread of a parallel visit.
+     * Nodes that override visit() return false, unless their visit() honours FLAGS_PARALLEL_VISIT and does no GL work.
+     *
+     * @since v3.3
+     */
+    virtual bool isParallelVisitSupported() const { return true; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1328,6 +1373,14 @@ public:
     virtual const Mat4& getNodeToParentTransform() const;
     virtual AffineTransform getNodeToParentAffineTransform() const;
 
+    /**
+     * Returns true if the node to parent transform has 3D components: a rotation around the X or Y axis,
+     * or a 3D additional transform. The transforms of the other nodes are composed as 2D affine transforms,
+     * which is much cheaper than a 4x4 matrix multiplication.
+     * @since v3.3
+     */
+    bool has3DTransform() const;
+
     /** 
      * Sets the Transformation matrix manually.
      */
@@ -1495,6 +1548,9 @@ protected:
     /// helper that reorder a child
     void insertChild(Node* child, int z);
 
+    /// Sorts the children, merging the ones added or reordered since the last sort with the others
+    void sortChildrenIncrementally();
+
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, ssize_t index, bool doCleanup);
 
@@ -1509,9 +1565,17 @@ protected:
     virtual void updateCascadeColor();
     virtual void disableCascadeColor();
     virtual void updateColor() {}
-    
-    bool doEnumerate(std::string name, std::function<bool (Node *)> callback) const;
-    bool doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const;
+
+    /// Tells the StaticBatchNode that baked this node and the SpatialIndexNode that indexes it, if any, that their caches are stale
+    inline void markRenderCacheDirty() { if (_staticBatchNode || _spatialIndexNode) invalidateRenderCache(); }
+    void invalidateRenderCache();
+
+    /// Visits the children in [first, last) with Renderer::visitInParallel
+    void visitChildrenInParallel(Renderer* renderer, ssize_t first, ssize_t last, uint32_t flags);
+    /// Returns whether every node below this one supports parallel visits, cached until the children change
+    bool isSubtreeParallelVisitSupported();
+    /// Marks the cached result of isSubtreeParallelVisitSupported() as stale, for this node and its ancestors
+    void invalidateParallelVisitSupport();
     
 #if CC_USE_PHYSICS
     void updatePhysicsBodyTransform(Scene* layer);
@@ -1521,7 +1585,17 @@ protected:
 #endif // CC_USE_PHYSICS
     
 private:
+    friend class NodePath;
+
     void addChildHelper(Node* child, int localZOrder, int tag, const std::string &name, bool setTag);
+
+    void markChildReordered(Node* child);
+
+    void addToChildIndex(Node* child);
+    void removeFromChildIndex(Node* child);
+    /* Looks up the child with that name in the index, child is set to nullptr if there is none.
+     Returns false if there is no index or several children have the name: the first one is found by scanning the children */
+    bool lookupChildByName(const std::string& name, size_t hash, Node** child) const;
     
 protected:
 
@@ -1560,6 +1634,7 @@ protected:
     mutable Mat4 _additionalTransform; ///< transform
     bool _useAdditionalTransform;   ///< The flag to check whether the additional transform is dirty
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
+    mutable bool _has3DTransform;   ///< whether _transform has 3D components, see has3DTransform()
 
     int _localZOrder;               ///< Local order (relative to its siblings) used to sort the node
     float _globalZOrder;            ///< Global order used to sort the node
@@ -1572,6 +1647,10 @@ protected:
     std::string _name;               ///<a string label, an user defined string to identify this node
     size_t _hashOfName;            ///<hash value of _name, used for speed in getChildByName
 
+    struct ChildIndex;
+    ChildIndex* _childIndex;         ///< children by tag and name hash, see setChildIndexEnabled()
+    bool _indexedByParent;           ///< whether this node is in the child index of its parent
+
     void *_userData;                ///< A user assingned void pointer, Can be point to any cpp object
     Ref *_userObject;               ///< A user assigned Object
 
@@ -1593,6 +1672,8 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _reorderPending;             ///< whether this node is in the _reorderedChildren of its parent
+    std::vector<Node*> _reorderedChildren; ///< children added or reordered since the last sort
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -1624,8 +1705,18 @@ protected:
     std::function<void()> _onEnterTransitionDidFinishCallback;
     std::function<void()> _onExitTransitionDidStartCallback;
 
+    StaticBatchNode* _staticBatchNode;  ///< weak reference to the StaticBatchNode that baked this node
+    SpatialIndexNode* _spatialIndexNode;  ///< weak reference to the parent, if it is a SpatialIndexNode
+
+    bool _parallelVisitEnabled;         ///< whether the children are visited from several threads
+    bool _subtreeParallelVisitSupported;    ///< cached result of isSubtreeParallelVisitSupported()
+    bool _parallelVisitSupportDirty;        ///< whether _subtreeParallelVisitSupported must be computed again
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
+
+    friend class StaticBatchNode;
+    friend class SpatialIndexNode;
     
 #if CC_USE_PHYSICS
     friend class Layer;
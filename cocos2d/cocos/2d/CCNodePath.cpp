@@ -0,0 +1,148 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCNodePath.h"
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+NodePath::NodePath(const std::string& path)
+: _path(path)
+, _recursive(false)
+{
+    CCASSERT(path.length() != 0, "Invalid name");
+
+    size_t length = path.length();
+    size_t subStrStartPos = 0;
+    size_t subStrLength = length;
+
+    // Starts with '//'?
+    if (length > 2 && path[0] == '/' && path[1] == '/')
+    {
+        _recursive = true;
+        subStrStartPos = 2;
+        subStrLength -= 2;
+    }
+
+    // End with '/..'?
+    bool searchFromParent = false;
+    if (length > 3 &&
+        path[length-3] == '/' &&
+        path[length-2] == '.' &&
+        path[length-1] == '.')
+    {
+        searchFromParent = true;
+        subStrLength -= 3;
+    }
+
+    std::string names = path.substr(subStrStartPos, subStrLength);
+    if (searchFromParent)
+    {
+        names.insert(0, "[[:alnum:]]+/");
+    }
+
+    std::hash<std::string> h;
+    size_t start = 0;
+    while (true)
+    {
+        size_t end = names.find('/', start);
+        Component component;
+        component.name = names.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        component.isLiteral = component.name.find_first_of(".[]{}()\\*+?^$|") == std::string::npos;
+        if (component.isLiteral)
+        {
+            component.hash = h(component.name);
+        }
+        else
+        {
+            component.hash = 0;
+            component.regex = std::regex(component.name);
+        }
+        _components.push_back(std::move(component));
+
+        if (end == std::string::npos)
+            break;
+        start = end + 1;
+    }
+}
+
+bool NodePath::enumerate(const Node* root, const std::function<bool(Node*)>& callback) const
+{
+    CCASSERT(callback != nullptr, "Invalid callback function");
+
+    if (_recursive)
+        return enumerateRecursively(root, callback);
+
+    return enumerateFrom(root, 0, callback);
+}
+
+bool NodePath::enumerateRecursively(const Node* node, const std::function<bool(Node*)>& callback) const
+{
+    // search from the node itself, then from its descendants
+    if (enumerateFrom(node, 0, callback))
+        return true;
+
+    for (const auto& child : node->getChildren())
+    {
+        if (enumerateRecursively(child, callback))
+            return true;
+    }
+
+    return false;
+}
+
+bool NodePath::enumerateFrom(const Node* node, size_t index, const std::function<bool(Node*)>& callback) const
+{
+    const Component& component = _components[index];
+    bool isLast = (index + 1 == _components.size());
+
+    if (component.isLiteral)
+    {
+        Node* child = nullptr;
+        if (node->lookupChildByName(component.name, component.hash, &child))
+        {
+            if (child == nullptr)
+                return false;
+            return isLast ? callback(child) : enumerateFrom(child, index + 1, callback);
+        }
+    }
+
+    for (const auto& child : node->getChildren())
+    {
+        bool matches = component.isLiteral ?
+            (child->_hashOfName == component.hash && child->_name == component.name) :
+            std::regex_match(child->_name, component.regex);
+
+        if (matches)
+        {
+            // terminate enumeration if callback return true
+            if (isLast ? callback(child) : enumerateFrom(child, index + 1, callback))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+NS_CC_END
@@ -0,0 +1,82 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_NODE_PATH_H__
+#define __CC_NODE_PATH_H__
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <functional>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+class Node;
+
+/** @brief A search path of Node::enumerateChildren() that is parsed once.
+
+ enumerateChildren() with a string parses the path and builds a regular expression for every child it tests.
+ A NodePath does it once: keep it to run the same search every frame.
+
+     static const NodePath path("//Hud/Score");
+     node->enumerateChildren(path, [](Node* score) { ...; return true; });
+
+ Path components without regular expression characters are compared with the hash of the names,
+ and looked up in the child index of the nodes that have one (see Node::setChildIndexEnabled()).
+ @since v3.3
+ */
+class CC_DLL NodePath
+{
+public:
+    /** parses the path, see Node::enumerateChildren() for its syntax */
+    explicit NodePath(const std::string& path);
+
+    const std::string& getPath() const { return _path; }
+
+    /** Calls callback for every node matching the path from root, until it returns true.
+     Returns true if the callback stopped the enumeration */
+    bool enumerate(const Node* root, const std::function<bool(Node*)>& callback) const;
+
+protected:
+    struct Component
+    {
+        std::string name;
+        bool isLiteral;     // the name has no regular expression character
+        size_t hash;        // hash of the name, if it is a literal
+        std::regex regex;   // if it is not a literal
+    };
+
+    bool enumerateRecursively(const Node* node, const std::function<bool(Node*)>& callback) const;
+    bool enumerateFrom(const Node* node, size_t component, const std::function<bool(Node*)>& callback) const;
+
+    std::string _path;
+    std::vector<Component> _components;
+    bool _recursive;
+};
+
+NS_CC_END
+
+#endif // __CC_NODE_PATH_H__
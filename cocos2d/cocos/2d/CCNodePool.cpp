@@ -0,0 +1,74 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCNodePool.h"
+
+NS_CC_BEGIN
+
+void NodeDefaults::capture(const Node* node)
+{
+    position = node->getPosition();
+    positionZ = node->getPositionZ();
+    anchorPoint = node->getAnchorPoint();
+    scaleX = node->getScaleX();
+    scaleY = node->getScaleY();
+    scaleZ = node->getScaleZ();
+    rotation3D = node->getRotation3D();
+    rotationSkewX = node->getRotationSkewX();
+    rotationSkewY = node->getRotationSkewY();
+    skewX = node->getSkewX();
+    skewY = node->getSkewY();
+    visible = node->isVisible();
+    localZOrder = node->getLocalZOrder();
+    globalZOrder = node->getGlobalZOrder();
+    color = node->getColor();
+    opacity = node->getOpacity();
+}
+
+void NodeDefaults::apply(Node* node) const
+{
+    node->setPosition(position);
+    node->setPositionZ(positionZ);
+    node->setAnchorPoint(anchorPoint);
+    node->setScaleX(scaleX);
+    node->setScaleY(scaleY);
+    node->setScaleZ(scaleZ);
+    node->setRotation3D(rotation3D);
+    node->setRotationSkewX(rotationSkewX);
+    node->setRotationSkewY(rotationSkewY);
+    node->setSkewX(skewX);
+    node->setSkewY(skewY);
+    node->setVisible(visible);
+    node->setLocalZOrder(localZOrder);
+    node->setGlobalZOrder(globalZOrder);
+    node->setColor(color);
+    node->setOpacity(opacity);
+
+    node->setTag(Node::INVALID_TAG);
+    node->setName("");
+    node->setUserData(nullptr);
+    node->setUserObject(nullptr);
+}
+
+NS_CC_END
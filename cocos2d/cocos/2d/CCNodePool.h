@@ -0,0 +1,207 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_NODE_POOL_H__
+#define __CC_NODE_POOL_H__
+
+#include <functional>
+
+#include "2d/CCNode.h"
+#include "base/CCVector.h"
+
+NS_CC_BEGIN
+
+/** @brief The properties that a NodePool restores on the nodes it recycles.
+
+ They are captured on the first node created by the pool, so a recycled Sprite gets back its anchor point
+ of (0.5, 0.5) and a recycled Node its anchor point of (0, 0).
+ @since v3.3
+ */
+struct CC_DLL NodeDefaults
+{
+    void capture(const Node* node);
+    void apply(Node* node) const;
+
+    Vec2 position;
+    float positionZ;
+    Vec2 anchorPoint;
+    float scaleX;
+    float scaleY;
+    float scaleZ;
+    Vec3 rotation3D;
+    float rotationSkewX;
+    float rotationSkewY;
+    float skewX;
+    float skewY;
+    bool visible;
+    int localZOrder;
+    float globalZOrder;
+    Color3B color;
+    GLubyte opacity;
+};
+
+/** @brief Statistics of a NodePool */
+struct CC_DLL NodePoolStats
+{
+    NodePoolStats() : created(0), reused(0), recycled(0), discarded(0) {}
+
+    /** number of nodes created by the pool, pre-warmed ones included */
+    ssize_t created;
+    /** number of obtain() calls served by a recycled node */
+    ssize_t reused;
+    /** number of nodes given back with recycle() and kept by the pool */
+    ssize_t recycled;
+    /** number of nodes given back with recycle() while the pool was full */
+    ssize_t discarded;
+};
+
+/** @brief Recycles the nodes of a type, to spawn bullets, pickups or effects without allocating them every time.
+
+ obtain() returns a node like create() does: autoreleased, ready to be added to a parent.
+ recycle() removes a node from its parent, cleans it up and resets it, then keeps it for the next obtain().
+
+     NodePool<Sprite> bullets([](){ return Sprite::create("bullet.png"); });
+     bullets.prewarm(64);
+
+     auto bullet = bullets.obtain();
+     layer->addChild(bullet);
+     ...
+     bullets.recycle(bullet);
+
+ A recycled node has no running action, no scheduled selector and no event listener. Its transform, color,
+ opacity, visibility and Z orders are restored as they were when the pool created it, its tag, name
+ and user data are cleared. Its children are kept. Anything else, like the texture of a sprite, is restored by
+ the reset function.
+ The pool must be used from the cocos thread.
+ @since v3.3
+ */
+template <class T>
+class NodePool
+{
+public:
+    /** creator returns an autoreleased node, as create() does. reset is called on the recycled nodes,
+     after their Node properties were restored. maxSize is the number of nodes kept, 0 keeps them all */
+    explicit NodePool(const std::function<T*()>& creator, const std::function<void(T*)>& reset = nullptr, ssize_t maxSize = 0)
+    : _creator(creator)
+    , _reset(reset)
+    , _maxSize(maxSize)
+    , _defaultsCaptured(false)
+    {
+        CCASSERT(creator != nullptr, "Invalid creator");
+    }
+
+    /** creates nodes until count of them are available */
+    void prewarm(ssize_t count)
+    {
+        _freeNodes.reserve(count);
+        while (_freeNodes.size() < count)
+        {
+            T* node = createNode();
+            if (node == nullptr)
+                break;
+            _freeNodes.pushBack(node);
+        }
+    }
+
+    /** returns an autoreleased node, recycled if possible. It may return nullptr if the creator fails */
+    T* obtain()
+    {
+        if (_freeNodes.empty())
+            return createNode();
+
+        T* node = _freeNodes.back();
+        node->retain();
+        _freeNodes.popBack();
+        node->autorelease();
+        ++_stats.reused;
+        return node;
+    }
+
+    /** removes the node from its parent, resets it and keeps it for the next obtain() */
+    void recycle(T* node)
+    {
+        CCASSERT(node != nullptr, "Invalid node");
+        CCASSERT(!_freeNodes.contains(node), "The node was already recycled");
+
+        // the parent may hold the last reference
+        node->retain();
+        node->removeFromParentAndCleanup(false);
+        // also done when the node has no parent, which removeFromParentAndCleanup() skips
+        node->cleanup();
+        node->getEventDispatcher()->removeEventListenersForTarget(node);
+
+        if (_maxSize == 0 || _freeNodes.size() < _maxSize)
+        {
+            _defaults.apply(node);
+            if (_reset)
+                _reset(node);
+            _freeNodes.pushBack(node);
+            ++_stats.recycled;
+        }
+        else
+        {
+            ++_stats.discarded;
+        }
+        node->release();
+    }
+
+    /** releases the recycled nodes */
+    void clear() { _freeNodes.clear(); }
+
+    /** number of nodes obtain() can return without creating one */
+    ssize_t getFreeCount() const { return _freeNodes.size(); }
+
+    const NodePoolStats& getStats() const { return _stats; }
+
+protected:
+    T* createNode()
+    {
+        T* node = _creator();
+        if (node)
+        {
+            if (!_defaultsCaptured)
+            {
+                _defaults.capture(node);
+                _defaultsCaptured = true;
+            }
+            ++_stats.created;
+        }
+        return node;
+    }
+
+    std::function<T*()> _creator;
+    std::function<void(T*)> _reset;
+    ssize_t _maxSize;
+    Vector<T*> _freeNodes;
+    NodeDefaults _defaults;
+    bool _defaultsCaptured;
+    NodePoolStats _stats;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(NodePool);
+};
+
+NS_CC_END
+
+#endif // __CC_NODE_POOL_H__
@@ -69,6 +69,7 @@ public:
     virtual void removeChild(Node* child, bool cleanup) override;
     virtual void removeAllChildrenWithCleanup(bool cleanup) override;
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
 
 protected:
     /** Adds a child to the container with a z-order, a parallax ratio and a position offset
@@ -92,6 +92,7 @@ public:
     
     // Overrides
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
 
     using Node::addChild;
     virtual void addChild(Node * child, int zOrder, int tag) override;
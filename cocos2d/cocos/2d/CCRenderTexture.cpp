@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "base/CCConfiguration.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "renderer/CCGLProgram.h"
@@ -45,6 +47,8 @@ THE SOFTWARE.
 
 #include "CCGL.h"
 
+#include <thread>
+
 
 NS_CC_BEGIN
 
@@ -81,6 +85,24 @@ RenderTexture::RenderTexture()
 
 RenderTexture::~RenderTexture()
 {
+    // each readback retains the node until its file is written, so this only happens after an extra release()
+    if (!_pendingReadbacks.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule("RenderTexture::updateAsyncReadbacks", &_pendingReadbacks);
+    }
+    for (auto readback : _pendingReadbacks)
+    {
+#ifdef GL_PIXEL_PACK_BUFFER
+        if (readback->pbo)
+        {
+            glDeleteBuffers(1, &readback->pbo);
+        }
+#endif
+        CC_SAFE_DELETE_ARRAY(readback->data);
+        delete readback;
+    }
+    _pendingReadbacks.clear();
+
     CC_SAFE_RELEASE(_sprite);
     CC_SAFE_RELEASE(_textureCopy);
     
@@ -404,13 +426,12 @@ void RenderTexture::visit(Renderer *renderer, const Mat4 &parentTransform, uint3
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewTransform(_modelViewTransform);
 
     _sprite->visit(renderer, _modelViewTransform, flags);
     draw(renderer, _modelViewTransform, flags);
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewTransform();
 
     _orderOfArrival = 0;
 }
@@ -461,6 +482,171 @@ void RenderTexture::onSaveToFile(const std::string& filename, bool isRGBA)
     CC_SAFE_DELETE(image);
 }
 
+void RenderTexture::saveToFileAsync(const std::string& fileName, Image::Format format, bool isRGBA,
+                                    const std::function<void(RenderTexture*, const std::string&, bool)>& callback)
+{
+    CCASSERT(format == Image::Format::JPG || format == Image::Format::PNG,
+             "the image can only be saved as JPG or PNG format");
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+    if (isRGBA && format == Image::Format::JPG)
+    {
+        CCLOG("RGBA is not supported for JPG format");
+        isRGBA = false;
+    }
+
+    auto readback = new (std::nothrow) AsyncReadback();
+    if (!readback)
+    {
+        if (callback)
+            callback(this, fileName, false);
+        return;
+    }
+    readback->fullpath = FileUtils::getInstance()->getWritablePath() + fileName;
+    readback->isRGBA = isRGBA;
+    readback->callback = callback;
+    readback->pbo = 0;
+    readback->data = nullptr;
+    readback->width = 0;
+    readback->height = 0;
+    readback->issued = false;
+    readback->framesLeft = 2;
+    readback->saved = false;
+    _pendingReadbacks.push_back(readback);
+
+    // released once the file has been written
+    retain();
+
+    readback->readCommand.init(_globalZOrder);
+    readback->readCommand.func = CC_CALLBACK_0(RenderTexture::onReadPixelsAsync, this, readback);
+    Director::getInstance()->getRenderer()->addCommand(&readback->readCommand);
+
+    // not scheduled on the node itself, pausing it must not hold back the readbacks
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (!scheduler->isScheduled("RenderTexture::updateAsyncReadbacks", &_pendingReadbacks))
+    {
+        scheduler->schedule(CC_CALLBACK_1(RenderTexture::updateAsyncReadbacks, this), &_pendingReadbacks, 0, false, "RenderTexture::updateAsyncReadbacks");
+    }
+}
+
+void RenderTexture::onReadPixelsAsync(AsyncReadback* readback)
+{
+    if (readback->issued)
+        return;
+
+    if (nullptr == _texture)
+    {
+        // nothing to read: without pixels the readback finishes as failed, which releases the node
+        readback->issued = true;
+        return;
+    }
+
+    const Size& s = _texture->getContentSizeInPixels();
+    readback->width = (int)s.width;
+    readback->height = (int)s.height;
+    GLsizeiptr size = readback->width * readback->height * 4;
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+#ifdef GL_PIXEL_PACK_BUFFER
+    // the read is queued into the buffer object and does not wait for the GPU
+    glGenBuffers(1, &readback->pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    glReadPixels(0, 0, readback->width, readback->height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#else
+    readback->data = new (std::nothrow) unsigned char[size];
+    if (readback->data)
+    {
+        glReadPixels(0, 0, readback->width, readback->height, GL_RGBA, GL_UNSIGNED_BYTE, readback->data);
+    }
+#endif
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+    CHECK_GL_ERROR_DEBUG();
+
+    readback->issued = true;
+}
+
+void RenderTexture::updateAsyncReadbacks(float dt)
+{
+    for (auto it = _pendingReadbacks.begin(); it != _pendingReadbacks.end(); )
+    {
+        AsyncReadback* readback = *it;
+        // wait for the GPU to finish the frames that were in flight when the read was issued
+        if (!readback->issued || --readback->framesLeft > 0)
+        {
+            ++it;
+            continue;
+        }
+        it = _pendingReadbacks.erase(it);
+        finishAsyncReadback(readback);
+    }
+
+    if (_pendingReadbacks.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule("RenderTexture::updateAsyncReadbacks", &_pendingReadbacks);
+    }
+}
+
+void RenderTexture::finishAsyncReadback(AsyncReadback* readback)
+{
+#ifdef GL_PIXEL_PACK_BUFFER
+    if (readback->pbo)
+    {
+        GLsizeiptr size = readback->width * readback->height * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+        void* mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (mapped)
+        {
+            readback->data = new (std::nothrow) unsigned char[size];
+            if (readback->data)
+            {
+                memcpy(readback->data, mapped, size);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(1, &readback->pbo);
+        readback->pbo = 0;
+    }
+#endif
+
+    // flip and encode on a worker thread, then report back on the cocos thread
+    ThreadPool::getInstance()->submit([readback]() {
+        if (readback->data)
+        {
+            int rowSize = readback->width * 4;
+            unsigned char* flipped = new (std::nothrow) unsigned char[rowSize * readback->height];
+            if (flipped)
+            {
+                for (int i = 0; i < readback->height; ++i)
+                {
+                    memcpy(&flipped[i * rowSize], &readback->data[(readback->height - i - 1) * rowSize], rowSize);
+                }
+
+                Image* image = new (std::nothrow) Image();
+                if (image && image->initWithRawData(flipped, rowSize * readback->height, readback->width, readback->height, 8))
+                {
+                    readback->saved = image->saveToFile(readback->fullpath, !readback->isRGBA);
+                }
+                CC_SAFE_DELETE(image);
+                delete[] flipped;
+            }
+            CC_SAFE_DELETE_ARRAY(readback->data);
+        }
+    }, ThreadPool::Priority::LOW).then([this, readback](){
+        if (readback->callback)
+        {
+            readback->callback(this, readback->fullpath, readback->saved);
+        }
+        delete readback;
+        release();
+    });
+}
+
 /* get buffer as Image */
 Image* RenderTexture::newImage(bool fliimage)
 {
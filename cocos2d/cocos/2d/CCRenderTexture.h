@@ -81,7 +81,7 @@ public:
     /** end is key word of lua, use other name to export to lua. */
     inline void endToLua(){ end();};
 
-    /** ends grabbing*/
+    /** ends grabbing. The shapes of the Renderer's DebugDrawBatch are not drawn into the texture */
     virtual void end();
 
     /** clears the texture with a color */
@@ -109,6 +109,16 @@ public:
         Returns true if the operation is successful.
      */
     bool saveToFile(const std::string& filename, Image::Format format, bool isRGBA = true);
+
+    /** Saves the texture into a file without stalling the GL pipeline. The file will be saved in the Documents folder.
+     The pixels are read into a pixel buffer object and mapped a couple of frames later, the PNG/JPG encoding runs on
+     a worker thread and the callback is invoked on the cocos thread with the full path and whether saving succeeded.
+     On platforms without pixel buffer objects the pixels are read synchronously, but the encoding is still done asynchronously.
+     The node is retained until the callback is invoked, the file is written even if the node is removed or paused before.
+     @since v3.3
+     */
+    void saveToFileAsync(const std::string& filename, Image::Format format, bool isRGBA,
+                         const std::function<void(RenderTexture*, const std::string&, bool)>& callback = nullptr);
     
     /** Listen "come to background" message, and save render texture.
      It only has effect on Android.
@@ -154,6 +164,7 @@ public:
     
     // Overrides
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
     //flag: use stack matrix computed from scene hierarchy or generate new modelView and projection matrix
@@ -214,6 +225,23 @@ protected:
     CustomCommand _beginCommand;
     CustomCommand _endCommand;
     CustomCommand _saveToFileCommand;
+
+    struct AsyncReadback
+    {
+        std::string fullpath;
+        bool isRGBA;
+        std::function<void(RenderTexture*, const std::string&, bool)> callback;
+        CustomCommand readCommand;
+        // pixel buffer object the pixels are read into, 0 when they were read synchronously into data
+        GLuint pbo;
+        unsigned char* data;
+        int width;
+        int height;
+        bool issued;
+        unsigned int framesLeft;
+        bool saved;
+    };
+    std::vector<AsyncReadback*> _pendingReadbacks;
 protected:
     //renderer caches and callbacks
     void onBegin();
@@ -223,6 +251,9 @@ protected:
     void onClearDepth();
 
     void onSaveToFile(const std::string& fileName, bool isRGBA = true);
+    void onReadPixelsAsync(AsyncReadback* readback);
+    void updateAsyncReadbacks(float dt);
+    void finishAsyncReadback(AsyncReadback* readback);
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
@@ -0,0 +1,412 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCSpatialIndexNode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+#include "base/CCDirector.h"
+
+NS_CC_BEGIN
+
+const float SpatialIndexNode::DEFAULT_CELL_SIZE = 256.0f;
+
+// keeps the cell coordinates of huge or broken bounding boxes in range
+static const float MAX_CELL_COORDINATE = (float)(1 << 30);
+
+static inline int toCell(float value, float cellSize)
+{
+    return (int)clampf(floorf(value / cellSize), -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE);
+}
+
+SpatialIndexNode* SpatialIndexNode::create(float cellSize)
+{
+    SpatialIndexNode* ret = new (std::nothrow) SpatialIndexNode();
+    if (ret && ret->initWithCellSize(cellSize))
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+SpatialIndexNode::SpatialIndexNode()
+: _cellSize(DEFAULT_CELL_SIZE)
+, _cullingMargin(0)
+, _cullingEnabled(true)
+, _visitMark(0)
+, _transformEpoch(0)
+, _visitedChildrenCount(0)
+{
+}
+
+SpatialIndexNode::~SpatialIndexNode()
+{
+    // the children may outlive this node
+    for (const auto& child : _children)
+    {
+        child->_spatialIndexNode = nullptr;
+    }
+}
+
+bool SpatialIndexNode::initWithCellSize(float cellSize)
+{
+    if (!Node::init())
+        return false;
+
+    CCASSERT(cellSize > 0, "Invalid cell size");
+    _cellSize = cellSize;
+    return true;
+}
+
+void SpatialIndexNode::setCellSize(float cellSize)
+{
+    CCASSERT(cellSize > 0, "Invalid cell size");
+    if (cellSize == _cellSize)
+        return;
+
+    _cellSize = cellSize;
+    _cells.clear();
+    _oversizedEntries.clear();
+    _dirtyEntries.clear();
+    for (auto& it : _entries)
+    {
+        auto& entry = it.second;
+        entry.firstX = entry.firstY = 1;
+        entry.lastX = entry.lastY = 0;
+        entry.oversized = false;
+        entry.dirty = true;
+        _dirtyEntries.push_back(&entry);
+    }
+}
+
+void SpatialIndexNode::addChild(Node *child, int zOrder, int tag)
+{
+    Node::addChild(child, zOrder, tag);
+    addToIndex(child);
+}
+
+void SpatialIndexNode::addChild(Node *child, int zOrder, const std::string &name)
+{
+    Node::addChild(child, zOrder, name);
+    addToIndex(child);
+}
+
+void SpatialIndexNode::removeAllChildrenWithCleanup(bool cleanup)
+{
+    // drop the whole index at once instead of removing the children one by one
+    for (const auto& child : _children)
+    {
+        child->_spatialIndexNode = nullptr;
+    }
+    _entries.clear();
+    _cells.clear();
+    _oversizedEntries.clear();
+    _dirtyEntries.clear();
+    _visibleEntries.clear();
+
+    Node::removeAllChildrenWithCleanup(cleanup);
+}
+
+void SpatialIndexNode::addToIndex(Node* child)
+{
+    CCASSERT(_entries.find(child) == _entries.end(), "child already indexed");
+
+    Entry& entry = _entries[child];
+    entry.node = child;
+    entry.firstX = entry.firstY = 1;
+    entry.lastX = entry.lastY = 0;
+    entry.oversized = false;
+    entry.dirty = true;
+    entry.visitMark = _visitMark;
+    // never visited: it needs its transform to be computed
+    entry.transformEpoch = _transformEpoch - 1;
+    _dirtyEntries.push_back(&entry);
+
+    child->_spatialIndexNode = this;
+}
+
+void SpatialIndexNode::removeFromIndex(Node* child)
+{
+    child->_spatialIndexNode = nullptr;
+
+    auto it = _entries.find(child);
+    if (it == _entries.end())
+        return;
+
+    Entry* entry = &it->second;
+    eraseEntry(entry);
+    if (entry->dirty)
+    {
+        _dirtyEntries.erase(std::find(_dirtyEntries.begin(), _dirtyEntries.end(), entry));
+    }
+    _entries.erase(it);
+}
+
+void SpatialIndexNode::setChildDirty(Node* child)
+{
+    auto it = _entries.find(child);
+    if (it == _entries.end() || it->second.dirty)
+        return;
+
+    it->second.dirty = true;
+    _dirtyEntries.push_back(&it->second);
+}
+
+void SpatialIndexNode::insertEntry(Entry* entry)
+{
+    // the bounding box is in the coordinate space of this node
+    Rect box = entry->node->getBoundingBox();
+    entry->firstX = toCell(box.getMinX(), _cellSize);
+    entry->firstY = toCell(box.getMinY(), _cellSize);
+    entry->lastX = toCell(box.getMaxX(), _cellSize);
+    entry->lastY = toCell(box.getMaxY(), _cellSize);
+
+    long long cellCount = (long long)(entry->lastX - entry->firstX + 1) * (entry->lastY - entry->firstY + 1);
+    entry->oversized = cellCount > MAX_CELLS_PER_CHILD;
+    if (entry->oversized)
+    {
+        _oversizedEntries.push_back(entry);
+        return;
+    }
+
+    for (int x = entry->firstX; x <= entry->lastX; ++x)
+    {
+        for (int y = entry->firstY; y <= entry->lastY; ++y)
+        {
+            _cells[getCellKey(x, y)].push_back(entry);
+        }
+    }
+}
+
+void SpatialIndexNode::eraseEntry(Entry* entry)
+{
+    if (entry->oversized)
+    {
+        _oversizedEntries.erase(std::find(_oversizedEntries.begin(), _oversizedEntries.end(), entry));
+        entry->oversized = false;
+        return;
+    }
+
+    for (int x = entry->firstX; x <= entry->lastX; ++x)
+    {
+        for (int y = entry->firstY; y <= entry->lastY; ++y)
+        {
+            auto it = _cells.find(getCellKey(x, y));
+            if (it == _cells.end())
+                continue;
+
+            auto& cell = it->second;
+            auto found = std::find(cell.begin(), cell.end(), entry);
+            if (found != cell.end())
+            {
+                // order inside a cell doesn't matter
+                *found = cell.back();
+                cell.pop_back();
+            }
+            if (cell.empty())
+            {
+                _cells.erase(it);
+            }
+        }
+    }
+
+    entry->firstX = entry->firstY = 1;
+    entry->lastX = entry->lastY = 0;
+}
+
+void SpatialIndexNode::updateIndex()
+{
+    for (const auto& entry : _dirtyEntries)
+    {
+        eraseEntry(entry);
+        insertEntry(entry);
+        entry->dirty = false;
+    }
+    _dirtyEntries.clear();
+}
+
+bool SpatialIndexNode::getVisibleRect(Rect* rect) const
+{
+    Mat4 inverse = _modelViewTransform;
+    if (!inverse.inverse())
+        return false;
+
+    // the screen is [0, winSize] in view space, see Renderer::checkVisibility()
+    Size winSize = Director::getInstance()->getWinSize();
+    Vec3 corners[4] = {
+        Vec3(0, 0, 0),
+        Vec3(winSize.width, 0, 0),
+        Vec3(0, winSize.height, 0),
+        Vec3(winSize.width, winSize.height, 0),
+    };
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (auto& corner : corners)
+    {
+        inverse.transformPoint(&corner);
+        minX = std::min(minX, corner.x);
+        minY = std::min(minY, corner.y);
+        maxX = std::max(maxX, corner.x);
+        maxY = std::max(maxY, corner.y);
+    }
+
+    rect->setRect(minX - _cullingMargin, minY - _cullingMargin,
+                  maxX - minX + 2 * _cullingMargin, maxY - minY + 2 * _cullingMargin);
+    return true;
+}
+
+void SpatialIndexNode::collectVisibleChildren(const Rect& rect)
+{
+    _visibleEntries.clear();
+    ++_visitMark;
+
+    int firstX = toCell(rect.getMinX(), _cellSize);
+    int firstY = toCell(rect.getMinY(), _cellSize);
+    int lastX = toCell(rect.getMaxX(), _cellSize);
+    int lastY = toCell(rect.getMaxY(), _cellSize);
+
+    long long cellCount = (long long)(lastX - firstX + 1) * (lastY - firstY + 1);
+    if (cellCount >= (long long)_entries.size())
+    {
+        // zoomed out: looking up the cells would cost more than testing every child
+        for (auto& it : _entries)
+        {
+            auto& entry = it.second;
+            if (entry.oversized ||
+                (entry.lastX >= firstX && entry.firstX <= lastX && entry.lastY >= firstY && entry.firstY <= lastY))
+            {
+                _visibleEntries.push_back(&entry);
+            }
+        }
+    }
+    else
+    {
+        for (int x = firstX; x <= lastX; ++x)
+        {
+            for (int y = firstY; y <= lastY; ++y)
+            {
+                auto it = _cells.find(getCellKey(x, y));
+                if (it == _cells.end())
+                    continue;
+
+                for (const auto& entry : it->second)
+                {
+                    // a child can be in several cells
+                    if (entry->visitMark != _visitMark)
+                    {
+                        entry->visitMark = _visitMark;
+                        _visibleEntries.push_back(entry);
+                    }
+                }
+            }
+        }
+        _visibleEntries.insert(_visibleEntries.end(), _oversizedEntries.begin(), _oversizedEntries.end());
+    }
+
+    std::sort(_visibleEntries.begin(), _visibleEntries.end(), [](const Entry* a, const Entry* b){
+        return nodeComparisonLess(a->node, b->node);
+    });
+}
+
+void SpatialIndexNode::visitChild(Renderer* renderer, Entry* entry, uint32_t flags)
+{
+    // the transform of this node may have changed while the child was culled
+    if (entry->transformEpoch != _transformEpoch)
+    {
+        flags |= FLAGS_DIRTY_MASK;
+        entry->transformEpoch = _transformEpoch;
+    }
+    entry->node->visit(renderer, _modelViewTransform, flags);
+}
+
+void SpatialIndexNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_cullingEnabled)
+    {
+        _visitedChildrenCount = _children.size();
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+
+    // quick return if not visible. children won't be drawn.
+    if (!_visible)
+    {
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    if (flags & FLAGS_DIRTY_MASK)
+    {
+        ++_transformEpoch;
+    }
+
+    bool useMatrixStack = !(flags & FLAGS_PARALLEL_VISIT);
+    Director* director = Director::getInstance();
+    if (useMatrixStack)
+    {
+        director->pushModelViewTransform(_modelViewTransform);
+    }
+
+    updateIndex();
+
+    Rect visibleRect;
+    if (getVisibleRect(&visibleRect))
+    {
+        collectVisibleChildren(visibleRect);
+    }
+    else
+    {
+        _visibleEntries.clear();
+    }
+    _visitedChildrenCount = _visibleEntries.size();
+
+    size_t i = 0;
+    // draw children zOrder < 0
+    for ( ; i < _visibleEntries.size(); ++i)
+    {
+        if (_visibleEntries[i]->node->getLocalZOrder() >= 0)
+            break;
+        visitChild(renderer, _visibleEntries[i], flags);
+    }
+    // self draw
+    this->draw(renderer, _modelViewTransform, flags);
+
+    for ( ; i < _visibleEntries.size(); ++i)
+    {
+        visitChild(renderer, _visibleEntries[i], flags);
+    }
+
+    if (useMatrixStack)
+    {
+        director->popModelViewTransform();
+    }
+}
+
+NS_CC_END
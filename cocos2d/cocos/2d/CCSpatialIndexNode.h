@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSPATIAL_INDEX_NODE_H__
+#define __CCSPATIAL_INDEX_NODE_H__
+
+#include <vector>
+#include <unordered_map>
+
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief SpatialIndexNode keeps its children in a uniform grid and only visits the ones that are on screen.
+
+ Regular nodes visit all their children, and each Sprite culls itself in draw(). With large worlds that is
+ too slow: a scrolling level with tens of thousands of mostly off-screen children pays for all of them every frame.
+ SpatialIndexNode buckets its children by their bounding box, in its own coordinate space, and every frame it only
+ visits the children that overlap the cells covered by the screen. Off-screen children, and all their descendants,
+ are skipped.
+
+ The index is updated incrementally: only the children whose transform or content size changed are moved to other cells.
+ Move the SpatialIndexNode itself (or its parents) to scroll the world, which doesn't change the index at all.
+
+ Limitations:
+ - Only the bounding box of each child is tested. If the descendants of a child are drawn outside of it,
+   use setCullingMargin() to grow the screen rectangle.
+ - The screen is assumed to map to [0, winSize] in view space, as in Renderer::checkVisibility().
+ @since v3.3
+ */
+class CC_DLL SpatialIndexNode : public Node
+{
+public:
+    /** Default width and height of the grid cells, in points */
+    static const float DEFAULT_CELL_SIZE;
+    /** Children that cover more cells than this are not indexed, and are tested every frame */
+    static const int MAX_CELLS_PER_CHILD = 64;
+
+    /** creates a SpatialIndexNode with the given size of the grid cells, in points */
+    static SpatialIndexNode* create(float cellSize = DEFAULT_CELL_SIZE);
+
+    /** Sets the width and height of the grid cells, in points. Rebuilds the index.
+     Use roughly the size of the screen divided by 4: smaller cells mean more cells to look up each frame,
+     bigger cells mean more off-screen children visited.
+     */
+    void setCellSize(float cellSize);
+    /** Returns the width and height of the grid cells, in points */
+    float getCellSize() const { return _cellSize; }
+
+    /** Sets how much the screen rectangle is grown, in points, before looking up the visible children */
+    void setCullingMargin(float margin) { _cullingMargin = margin; }
+    /** Returns how much the screen rectangle is grown, in points */
+    float getCullingMargin() const { return _cullingMargin; }
+
+    /** Sets whether culling is enabled. When disabled, the children are visited as in a regular Node */
+    void setCullingEnabled(bool enabled) { _cullingEnabled = enabled; }
+    /** Returns whether culling is enabled */
+    bool isCullingEnabled() const { return _cullingEnabled; }
+
+    /** Returns the number of children that were visited in the last frame */
+    ssize_t getVisitedChildrenCount() const { return _visitedChildrenCount; }
+
+    /** Marks the bounding box of `child` as stale. Called automatically when its transform or content size changes */
+    void setChildDirty(Node* child);
+
+    // Overrides
+    using Node::addChild;
+    virtual void addChild(Node *child, int zOrder, int tag) override;
+    virtual void addChild(Node *child, int zOrder, const std::string &name) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    SpatialIndexNode();
+    virtual ~SpatialIndexNode();
+    bool initWithCellSize(float cellSize);
+
+protected:
+    struct Entry
+    {
+        Node* node;
+        // cells covered by the bounding box, inclusive. firstX > lastX if the child is not in the grid
+        int firstX, firstY, lastX, lastY;
+        bool dirty;
+        bool oversized;
+        unsigned int visitMark;
+        // value of _transformEpoch when the child was last visited
+        unsigned int transformEpoch;
+    };
+
+    static inline long long getCellKey(int x, int y) { return ((long long)x << 32) | (unsigned int)y; }
+
+    void addToIndex(Node* child);
+    void removeFromIndex(Node* child);
+    void insertEntry(Entry* entry);
+    void eraseEntry(Entry* entry);
+    void updateIndex();
+    bool getVisibleRect(Rect* rect) const;
+    void collectVisibleChildren(const Rect& rect);
+    void visitChild(Renderer* renderer, Entry* entry, uint32_t flags);
+
+    float _cellSize;
+    float _cullingMargin;
+    bool _cullingEnabled;
+
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<long long, std::vector<Entry*>> _cells;
+    std::vector<Entry*> _oversizedEntries;
+    std::vector<Entry*> _dirtyEntries;
+    std::vector<Entry*> _visibleEntries;
+
+    unsigned int _visitMark;
+    unsigned int _transformEpoch;
+    ssize_t _visitedChildrenCount;
+
+    friend class Node;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(SpatialIndexNode);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSPATIAL_INDEX_NODE_H__
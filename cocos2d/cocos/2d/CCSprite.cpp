@@ -121,6 +121,18 @@ Sprite* Sprite::createWithSpriteFrame(SpriteFrame *spriteFrame)
     return nullptr;
 }
 
+Sprite* Sprite::createInDynamicAtlas(const std::string& filename)
+{
+    Sprite *sprite = new (std::nothrow) Sprite();
+    if (sprite && sprite->initWithFileInDynamicAtlas(filename))
+    {
+        sprite->autorelease();
+        return sprite;
+    }
+    CC_SAFE_DELETE(sprite);
+    return nullptr;
+}
+
 Sprite* Sprite::createWithSpriteFrameName(const std::string& spriteFrameName)
 {
     SpriteFrame *frame = SpriteFrameCache::getInstance()->getSpriteFrameByName(spriteFrameName);
@@ -200,6 +212,20 @@ bool Sprite::initWithFile(const std::string &filename, const Rect& rect)
     return false;
 }
 
+bool Sprite::initWithFileInDynamicAtlas(const std::string& filename)
+{
+    CCASSERT(filename.size()>0, "Invalid filename for sprite");
+
+    Rect rect;
+    Texture2D *texture = Director::getInstance()->getTextureCache()->addImageToDynamicAtlas(filename, &rect);
+    if (texture)
+    {
+        return initWithTexture(texture, CC_RECT_PIXELS_TO_POINTS(rect));
+    }
+
+    return false;
+}
+
 bool Sprite::initWithSpriteFrameName(const std::string& spriteFrameName)
 {
     CCASSERT(spriteFrameName.size() > 0, "Invalid spriteFrameName");
@@ -348,6 +374,7 @@ void Sprite::setTexture(Texture2D *texture)
         CC_SAFE_RELEASE(_texture);
         _texture = texture;
         updateBlendFunc();
+        markRenderCacheDirty();
     }
 }
 
@@ -364,6 +391,7 @@ void Sprite::setTextureRect(const Rect& rect)
 void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimmedSize)
 {
     _rectRotated = rotated;
+    markRenderCacheDirty();
 
     setContentSize(untrimmedSize);
     setVertexRect(rect);
@@ -588,7 +616,10 @@ void Sprite::updateTransform(void)
 void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     // Don't do calculate the culling if the transform was not updated
-    _insideBounds = (flags & FLAGS_TRANSFORM_DIRTY) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
+    if (flags & FLAGS_SKIP_CULLING)
+        _insideBounds = true;
+    else
+        _insideBounds = (flags & FLAGS_TRANSFORM_DIRTY) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
 
     if(_insideBounds)
     {
@@ -709,7 +740,7 @@ void Sprite::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        std::sort(std::begin(_children), std::end(_children), nodeComparisonLess);
+        sortChildrenIncrementally();
 
         if ( _batchNode)
         {
@@ -905,6 +936,8 @@ void Sprite::updateColor(void)
     _quad.tl.colors = color4;
     _quad.tr.colors = color4;
 
+    markRenderCacheDirty();
+
     // renders using batch node
     if (_batchNode)
     {
@@ -154,6 +154,21 @@ public:
      */
     static Sprite* createWithSpriteFrameName(const std::string& spriteFrameName);
 
+    /**
+     * Creates a sprite with an image filename, packed into a shared page of the dynamic atlas.
+     *
+     * Sprites sharing a page are batched together by the renderer. See TextureCache::setDynamicAtlasEnabled().
+     * If the atlas is disabled or can't hold the image, this behaves like create(filename).
+     * Otherwise getTexture() returns the whole page, and the texture rect is the region of the image in the page:
+     * rects passed to setTextureRect() must be offset by the origin of the initial getTextureRect().
+     * Wrap modes such as GL_REPEAT don't apply to an atlased image.
+     *
+     * @param   filename A path to image file, e.g., "scene1/monster.png"
+     * @return  An autoreleased sprite object.
+     * @since v3.3
+     */
+    static Sprite* createInDynamicAtlas(const std::string& filename);
+
     /// @}  end of creators group
 
 
@@ -383,7 +398,7 @@ public:
     *In lua: local setBlendFunc(local src, local dst)
     *@endcode
     */
-    inline void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; }
+    inline void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; markRenderCacheDirty(); }
     /**
     * @js  NA
     * @lua NA
@@ -518,6 +533,13 @@ CC_CONSTRUCTOR_ACCESS:
      */
     virtual bool initWithFile(const std::string& filename, const Rect& rect);
 
+    /**
+     * Initializes a sprite with an image filename, packed into a shared page of the dynamic atlas.
+     * @see createInDynamicAtlas
+     * @since v3.3
+     */
+    bool initWithFileInDynamicAtlas(const std::string& filename);
+
 protected:
 
     void updateColor(void);
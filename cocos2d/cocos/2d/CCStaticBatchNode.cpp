@@ -0,0 +1,340 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCStaticBatchNode.h"
+
+#include <algorithm>
+
+#include "renderer/CCRenderer.h"
+#include "renderer/CCGroupCommand.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/ccGLStateCache.h"
+#include "base/CCDirector.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+
+NS_CC_BEGIN
+
+// 16-bit indices can address 65536 vertices, 4 per quad
+static const ssize_t MAX_QUADS_PER_DRAW = 65536 / 4;
+
+StaticBatchNode* StaticBatchNode::create()
+{
+    StaticBatchNode* ret = new (std::nothrow) StaticBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+StaticBatchNode::StaticBatchNode()
+: _bakeDirty(true)
+, _baked(false)
+, _vboDirty(true)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, _rendererRecreatedListener(nullptr)
+#endif
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+}
+
+StaticBatchNode::~StaticBatchNode()
+{
+    // the children may outlive this node
+    for (const auto& child : _children)
+    {
+        setStaticBatchNode(child, nullptr);
+    }
+
+    if (_buffersVBO[0])
+    {
+        glDeleteBuffers(2, _buffersVBO);
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_rendererRecreatedListener);
+#endif
+}
+
+bool StaticBatchNode::init()
+{
+    if (!Node::init())
+        return false;
+
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR));
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
+        /** listen the event that renderer was recreated on Android/WP8 */
+        _buffersVBO[0] = _buffersVBO[1] = 0;
+        _vboDirty = true;
+    });
+    Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+#endif
+
+    return true;
+}
+
+void StaticBatchNode::setStaticBatchNode(Node* node, StaticBatchNode* batch)
+{
+    node->_staticBatchNode = batch;
+    for (const auto& child : node->_children)
+    {
+        setStaticBatchNode(child, batch);
+    }
+}
+
+void StaticBatchNode::addChild(Node *child, int zOrder, int tag)
+{
+    Node::addChild(child, zOrder, tag);
+    _bakeDirty = true;
+}
+
+void StaticBatchNode::addChild(Node *child, int zOrder, const std::string &name)
+{
+    Node::addChild(child, zOrder, name);
+    _bakeDirty = true;
+}
+
+void StaticBatchNode::reorderChild(Node *child, int zOrder)
+{
+    Node::reorderChild(child, zOrder);
+    _bakeDirty = true;
+}
+
+void StaticBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+    {
+        return;
+    }
+
+    if (_bakeDirty)
+    {
+        bake(renderer);
+    }
+
+    if (!_baked)
+    {
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    draw(renderer, _modelViewTransform, flags);
+}
+
+void StaticBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
+{
+    if (!_baked || _quads.empty())
+    {
+        return;
+    }
+
+    _customCommand.init(_globalZOrder);
+    _customCommand.func = CC_CALLBACK_0(StaticBatchNode::onDraw, this, transform);
+    renderer->addCommand(&_customCommand);
+}
+
+void StaticBatchNode::bake(Renderer *renderer)
+{
+    _bakeDirty = false;
+    _quads.clear();
+    _runs.clear();
+    _vboDirty = true;
+
+    for (const auto& child : _children)
+    {
+        setStaticBatchNode(child, this);
+    }
+
+    // Capture the commands of the children in a render queue that is never rendered.
+    // They are visited in the space of this node and without culling.
+    auto manager = renderer->getGroupCommandManager();
+    int renderQueueID = manager->getGroupID();
+    renderer->pushGroup(renderQueueID);
+
+    sortAllChildren();
+    for (const auto& child : _children)
+    {
+        child->visit(renderer, Mat4::IDENTITY, FLAGS_DIRTY_MASK | FLAGS_SKIP_CULLING);
+    }
+
+    renderer->popGroup();
+
+    RenderQueue& queue = renderer->getRenderQueue(renderQueueID);
+    queue.sort();
+    _baked = captureQueue(queue);
+    queue.clear();
+    manager->releaseGroupID(renderQueueID);
+
+    if (!_baked)
+    {
+        CCLOG("cocos2d: StaticBatchNode: children can't be baked, visiting them instead");
+        _quads.clear();
+        _runs.clear();
+
+        // don't try again every time a child changes, only when children are added or setBakeDirty() is called
+        for (const auto& child : _children)
+        {
+            setStaticBatchNode(child, nullptr);
+        }
+    }
+
+    // the transforms of the children are relative to this node now
+    _transformUpdated = true;
+}
+
+bool StaticBatchNode::captureQueue(const RenderQueue& queue)
+{
+    auto defaultProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+
+    for (ssize_t index = 0; index < queue.size(); ++index)
+    {
+        auto command = queue[index];
+        if (command->getType() != RenderCommand::Type::QUAD_COMMAND)
+        {
+            return false;
+        }
+
+        auto cmd = static_cast<QuadCommand*>(command);
+        auto glProgramState = cmd->getGLProgramState();
+        if (glProgramState->getGLProgram() != defaultProgram || glProgramState->getUniformCount() > 0)
+        {
+            return false;
+        }
+
+        const BlendFunc& blendFunc = cmd->getBlendType();
+        if (_runs.empty() || _runs.back().textureID != cmd->getTextureID() || !(_runs.back().blendFunc == blendFunc))
+        {
+            Run run;
+            run.textureID = cmd->getTextureID();
+            run.blendFunc = blendFunc;
+            run.start = _quads.size();
+            run.count = 0;
+            _runs.push_back(run);
+        }
+
+        const Mat4& modelView = cmd->getModelView();
+        for (ssize_t i = 0; i < cmd->getQuadCount(); ++i)
+        {
+            V3F_C4B_T2F_Quad quad = cmd->getQuads()[i];
+            modelView.transformPoint(&quad.bl.vertices);
+            modelView.transformPoint(&quad.br.vertices);
+            modelView.transformPoint(&quad.tl.vertices);
+            modelView.transformPoint(&quad.tr.vertices);
+            _quads.push_back(quad);
+        }
+        _runs.back().count += cmd->getQuadCount();
+    }
+
+    return true;
+}
+
+void StaticBatchNode::setupBuffers()
+{
+    if (_buffersVBO[0] == 0)
+    {
+        glGenBuffers(2, &_buffersVBO[0]);
+    }
+
+    // Avoid changing the element buffer for whatever VAO might be bound.
+    GL::bindVAO(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _quads.size(), _quads.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    ssize_t quadCount = std::min(static_cast<ssize_t>(_quads.size()), MAX_QUADS_PER_DRAW);
+    std::vector<GLushort> indices(quadCount * 6);
+    for (ssize_t i = 0; i < quadCount; ++i)
+    {
+        indices[i*6+0] = (GLushort) (i*4+0);
+        indices[i*6+1] = (GLushort) (i*4+1);
+        indices[i*6+2] = (GLushort) (i*4+2);
+        indices[i*6+3] = (GLushort) (i*4+3);
+        indices[i*6+4] = (GLushort) (i*4+2);
+        indices[i*6+5] = (GLushort) (i*4+1);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * indices.size(), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+
+    _vboDirty = false;
+}
+
+void StaticBatchNode::onDraw(const Mat4 &transform)
+{
+    if (_vboDirty)
+    {
+        setupBuffers();
+    }
+
+    getGLProgramState()->apply(transform);
+
+    GL::bindVAO(0);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+
+    ssize_t drawCalls = 0;
+    for (const auto& run : _runs)
+    {
+        GL::bindTexture2D(run.textureID);
+        GL::blendFunc(run.blendFunc.src, run.blendFunc.dst);
+
+        // long runs are split, since the indices can't address the whole buffer
+        for (ssize_t start = run.start; start < run.start + run.count; start += MAX_QUADS_PER_DRAW)
+        {
+            ssize_t count = std::min(MAX_QUADS_PER_DRAW, run.start + run.count - start);
+            size_t offset = start * sizeof(V3F_C4B_T2F_Quad);
+
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+
+            glDrawElements(GL_TRIANGLES, (GLsizei) count * 6, GL_UNSIGNED_SHORT, (GLvoid*) 0);
+            ++drawCalls;
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(drawCalls, _quads.size() * 6);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
@@ -0,0 +1,133 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCSTATIC_BATCH_NODE_H__
+#define __CCSTATIC_BATCH_NODE_H__
+
+#include <vector>
+
+#include "2d/CCNode.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class EventListenerCustom;
+class RenderQueue;
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief StaticBatchNode bakes the quads of its children into a cached vertex buffer.
+
+ Once baked, the children are not visited anymore: their quads are kept in the local space of the
+ StaticBatchNode and drawn with a single command, so moving, rotating or scaling the StaticBatchNode itself
+ is free. The cache is rebuilt only when a descendant changes its transform, color, texture,
+ visibility or children.
+
+ Use it for decoration that never changes, like backgrounds or level geometry.
+
+ Limitations:
+ - Only descendants rendered with `QuadCommand`s and the default sprite shader can be baked (Sprite and its subclasses).
+   If any descendant emits another kind of command, the children are visited as in a regular Node
+   until a child is added or setBakeDirty() is called.
+ - The globalZOrder of the descendants is only honoured among themselves.
+ - Descendants are never culled.
+ @since v3.3
+ */
+class CC_DLL StaticBatchNode : public Node
+{
+public:
+    /** creates a StaticBatchNode */
+    static StaticBatchNode* create();
+
+    /** Forces the cache to be rebuilt the next time the node is visited */
+    void setBakeDirty() { _bakeDirty = true; }
+
+    /** Returns whether or not the children are currently drawn from the cache */
+    bool isBaked() const { return _baked; }
+
+    /** Returns the number of quads in the cache */
+    ssize_t getBakedQuadCount() const { return _quads.size(); }
+
+    // Overrides
+    using Node::addChild;
+    virtual void addChild(Node *child, int zOrder, int tag) override;
+    virtual void addChild(Node *child, int zOrder, const std::string &name) override;
+    virtual void reorderChild(Node *child, int zOrder) override;
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
+    virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    StaticBatchNode();
+    virtual ~StaticBatchNode();
+    virtual bool init() override;
+
+protected:
+    /** Quads sharing a texture and a blend function, drawn with a single glDrawElements call */
+    struct Run
+    {
+        GLuint textureID;
+        BlendFunc blendFunc;
+        ssize_t start;
+        ssize_t count;
+    };
+
+    /** Sets `batch` as the StaticBatchNode of `node` and all its descendants */
+    static void setStaticBatchNode(Node* node, StaticBatchNode* batch);
+
+    void bake(Renderer *renderer);
+    bool captureQueue(const RenderQueue& queue);
+    void setupBuffers();
+    void onDraw(const Mat4 &transform);
+
+    std::vector<V3F_C4B_T2F_Quad> _quads;
+    std::vector<Run> _runs;
+
+    bool _bakeDirty;
+    bool _baked;
+
+    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    bool _vboDirty;
+
+    CustomCommand _customCommand;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _rendererRecreatedListener;
+#endif
+
+    friend class Node;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(StaticBatchNode);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSTATIC_BATCH_NODE_H__
@@ -224,6 +224,7 @@ Sprite3D::Sprite3D()
 , _skin(nullptr)
 , _texture(nullptr)
 , _blend(BlendFunc::ALPHA_NON_PREMULTIPLIED)
+, _depthWriteEnabled(false)
 {
 }
 
@@ -340,6 +341,7 @@ void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     
     _meshCommand.setCullFaceEnabled(true);
     _meshCommand.setDepthTestEnabled(true);
+    _meshCommand.setDepthWriteEnabled(_depthWriteEnabled);
     if (_skin)
     {
         _meshCommand.setMatrixPaletteSize((int)_skin->getMatrixPaletteSize());
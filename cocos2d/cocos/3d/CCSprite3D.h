@@ -60,6 +60,13 @@ public:
     /**get skin*/
     MeshSkin* getSkin() const { return _skin; }
 
+    /** Enables writing to the depth buffer. Disabled by default.
+     Unblended sprites with depth write enabled are drawn as opaque meshes, which the renderer may reorder.
+     @since v3.3
+     */
+    void setDepthWriteEnabled(bool enable) { _depthWriteEnabled = enable; }
+    bool isDepthWriteEnabled() const { return _depthWriteEnabled; }
+
     // overrides
     virtual void setBlendFunc(const BlendFunc &blendFunc) override;
     virtual const BlendFunc &getBlendFunc() const override;
@@ -92,6 +99,7 @@ protected:
     MeshCommand       _meshCommand; //render command
     Texture2D*        _texture;
     BlendFunc         _blend;
+    bool              _depthWriteEnabled;
 };
 
 extern std::string s_attributeNames[];//attribute names array
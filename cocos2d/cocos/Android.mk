@@ -49,6 +49,8 @@ cocos2d.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
 2d/CCNodeGrid.cpp \
+2d/CCNodePath.cpp \
+2d/CCNodePool.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
@@ -61,6 +63,8 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCStaticBatchNode.cpp \
+2d/CCSpatialIndexNode.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCFastTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
@@ -122,9 +126,11 @@ base/CCEventMouse.cpp \
 base/CCEventTouch.cpp \
 base/CCIMEDispatcher.cpp \
 base/CCNS.cpp \
+base/CCObjectArena.cpp \
 base/CCProfiling.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCThreadPool.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault.cpp \
@@ -146,6 +152,8 @@ base/CCController-android.cpp \
 base/ObjectFactory.cpp \
 renderer/CCBatchCommand.cpp \
 renderer/CCCustomCommand.cpp \
+renderer/CCDebugDrawBatch.cpp \
+renderer/CCDynamicAtlas.cpp \
 renderer/CCGLProgram.cpp \
 renderer/CCGLProgramCache.cpp \
 renderer/CCGLProgramState.cpp \
@@ -155,6 +163,8 @@ renderer/CCQuadCommand.cpp \
 renderer/CCMeshCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
+renderer/CCRenderCapture.cpp \
+renderer/CCRenderStats.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
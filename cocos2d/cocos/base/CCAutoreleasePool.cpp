@@ -25,10 +25,18 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
 
+#include <algorithm>
+#include <typeinfo>
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#include <stdlib.h>
+#endif
+
 NS_CC_BEGIN
 
 AutoreleasePool::AutoreleasePool()
 : _name("")
+, _statsEnabled(false)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
@@ -39,6 +47,7 @@ AutoreleasePool::AutoreleasePool()
 
 AutoreleasePool::AutoreleasePool(const std::string &name)
 : _name(name)
+, _statsEnabled(false)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
@@ -58,6 +67,11 @@ AutoreleasePool::~AutoreleasePool()
 void AutoreleasePool::addObject(Ref* object)
 {
     _managedObjectArray.push_back(object);
+
+    if (_statsEnabled)
+    {
+        ++_typeCounts[std::type_index(typeid(*object))];
+    }
 }
 
 void AutoreleasePool::clear()
@@ -65,6 +79,36 @@ void AutoreleasePool::clear()
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = true;
 #endif
+    if (_statsEnabled)
+    {
+        _lastClearStats.clear();
+        for (const auto& typeCount : _typeCounts)
+        {
+            if (typeCount.second == 0)
+                continue;
+
+            std::string name = typeCount.first.name();
+#if defined(__GNUC__)
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+            if (demangled)
+            {
+                name = demangled;
+                free(demangled);
+            }
+#endif
+            _lastClearStats.push_back(std::make_pair(name, typeCount.second));
+        }
+        std::sort(_lastClearStats.begin(), _lastClearStats.end(),
+                  [](const std::pair<std::string, ssize_t>& a, const std::pair<std::string, ssize_t>& b) { return a.second > b.second; });
+
+        // keep the keys, the same types come back every frame
+        for (auto& typeCount : _typeCounts)
+        {
+            typeCount.second = 0;
+        }
+    }
+
     for (const auto &obj : _managedObjectArray)
     {
         obj->release();
@@ -96,6 +140,22 @@ void AutoreleasePool::dump()
     }
 }
 
+void AutoreleasePool::setStatsEnabled(bool enabled)
+{
+    _statsEnabled = enabled;
+    _typeCounts.clear();
+    _lastClearStats.clear();
+}
+
+void AutoreleasePool::dumpStats()
+{
+    CCLOG("autorelease pool: %s, objects autoreleased before the last clear by type", _name.c_str());
+    for (const auto& typeCount : _lastClearStats)
+    {
+        CCLOG("%8ld %s", (long)typeCount.second, typeCount.first.c_str());
+        CC_UNUSED_PARAM(typeCount);
+    }
+}
 
 //--------------------------------------------------------------------
 //
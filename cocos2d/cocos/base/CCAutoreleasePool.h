@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include <stack>
 #include <vector>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
 #include "base/CCRef.h"
 
 NS_CC_BEGIN
@@ -101,6 +103,30 @@ public:
      *
      */
     void dump();
+
+    /**
+     * Counts the autoreleased objects by type, to find the temporary objects created every frame.
+     * It costs a type lookup per autorelease, it is disabled by default.
+     *
+     * @since v3.3
+     */
+    void setStatsEnabled(bool enabled);
+    bool isStatsEnabled() const { return _statsEnabled; }
+
+    /**
+     * Returns the number of objects autoreleased by type before the last `clear`, most frequent first.
+     * For the pool of the Director, that is the objects autoreleased during the last frame.
+     *
+     * @since v3.3
+     */
+    const std::vector<std::pair<std::string, ssize_t>>& getLastClearStats() const { return _lastClearStats; }
+
+    /**
+     * Logs the stats of the last `clear`.
+     *
+     * @since v3.3
+     */
+    void dumpStats();
     
 private:
     /**
@@ -114,6 +140,10 @@ private:
      */
     std::vector<Ref*> _managedObjectArray;
     std::string _name;
+
+    bool _statsEnabled;
+    std::unordered_map<std::type_index, ssize_t> _typeCounts;
+    std::vector<std::pair<std::string, ssize_t>> _lastClearStats;
     
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     /**
@@ -47,6 +47,7 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsProgramBinary(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -142,6 +143,23 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || defined(__glew_h__)
+    // the entry points are function pointers loaded at runtime, and may be missing
+    _supportsProgramBinary = checkForGLExtension("get_program_binary") && glGetProgramBinary && glProgramBinary;
+#else
+    _supportsProgramBinary = checkForGLExtension("get_program_binary");
+#endif
+    if (_supportsProgramBinary)
+    {
+        // some drivers expose the extension without any binary format
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        _supportsProgramBinary = (formats > 0);
+    }
+#endif
+    _valueDict["gl.supports_program_binary"] = Value(_supportsProgramBinary);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -238,6 +256,11 @@ bool Configuration::supportsDiscardFramebuffer() const
 	return _supportsDiscardFramebuffer;
 }
 
+bool Configuration::supportsProgramBinary() const
+{
+    return _supportsProgramBinary;
+}
+
 bool Configuration::supportsShareableVAO() const
 {
 #if CC_TEXTURE_ATLAS_USE_VAO
@@ -110,6 +110,12 @@ public:
      */
 	bool supportsShareableVAO() const;
 
+    /** Whether or not the binaries of linked programs can be saved and loaded, with
+     GL_OES_get_program_binary or GL_ARB_get_program_binary.
+     @since v3.3
+     */
+    bool supportsProgramBinary() const;
+
     /** returns whether or not an OpenGL is supported */
     bool checkForGLExtension(const std::string &searchName) const;
 
@@ -146,6 +152,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsProgramBinary;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -61,6 +61,7 @@
 #include "2d/CCScene.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCRenderer.h"
 #include "CCGLView.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
@@ -291,6 +292,7 @@ Console::Console()
         } },
         { "help", "Print this message", std::bind(&Console::commandHelp, this, std::placeholders::_1, std::placeholders::_2) },
         { "projection", "Change or print the current projection. Args: [2d | 3d]", std::bind(&Console::commandProjection, this, std::placeholders::_1, std::placeholders::_2) },
+        { "renderer", "Print the statistics of the last rendered frame", std::bind(&Console::commandRenderer, this, std::placeholders::_1, std::placeholders::_2) },
         { "resolution", "Change or print the window resolution. Args: [width height resolution_policy | ]", std::bind(&Console::commandResolution, this, std::placeholders::_1, std::placeholders::_2) },
         { "scenegraph", "Print the scene graph", std::bind(&Console::commandSceneGraph, this, std::placeholders::_1, std::placeholders::_2) },
         { "texture", "Flush or print the TextureCache info. Args: [flush | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
@@ -592,6 +594,15 @@ void Console::commandTextures(int fd, const std::string& args)
     }
 }
 
+void Console::commandRenderer(int fd, const std::string& args)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        mydprintf(fd, "%s", Director::getInstance()->getRenderer()->getFrameStats().getDescription().c_str());
+        sendPrompt(fd);
+    }
+                                        );
+}
 
 void Console::commandDirector(int fd, const std::string& args)
 {
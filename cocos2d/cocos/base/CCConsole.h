@@ -118,6 +118,7 @@ protected:
     void commandFileUtils(int fd, const std::string &args);
     void commandConfig(int fd, const std::string &args);
     void commandTextures(int fd, const std::string &args);
+    void commandRenderer(int fd, const std::string &args);
     void commandResolution(int fd, const std::string &args);
     void commandProjection(int fd, const std::string &args);
     void commandDirector(int fd, const std::string &args);
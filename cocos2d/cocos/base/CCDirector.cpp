@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 // standard includes
 #include <string>
+#include <chrono>
 
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCScene.h"
@@ -50,6 +51,7 @@ THE SOFTWARE.
 #include "base/CCUserDefault.h"
 #include "base/ccFPSImages.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
@@ -154,6 +156,7 @@ bool Director::init(void)
 
     //init TextureCache
     initTextureCache();
+    _matrixStackEnabled = true;
     initMatrixStack();
 
     _renderer = new Renderer;
@@ -284,6 +287,8 @@ void Director::drawScene()
 
     pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
+    auto visitStart = std::chrono::high_resolution_clock::now();
+
     // draw the scene
     if (_runningScene)
     {
@@ -297,6 +302,9 @@ void Director::drawScene()
         _notificationNode->visit(_renderer, Mat4::IDENTITY, false);
     }
 
+    auto visitEnd = std::chrono::high_resolution_clock::now();
+    _renderer->setFrameVisitTime(std::chrono::duration_cast<std::chrono::microseconds>(visitEnd - visitStart).count() / 1000.0f);
+
     if (_displayStats)
     {
         showStats();
@@ -309,6 +317,17 @@ void Director::drawScene()
 
     _totalFrames++;
 
+    // spend the time left in the frame on the sliced jobs, before waiting for the swap
+    if (! _paused)
+    {
+        struct timeval now;
+        if (gettimeofday(&now, nullptr) == 0)
+        {
+            float elapsed = (now.tv_sec - _lastUpdate->tv_sec) + (now.tv_usec - _lastUpdate->tv_usec) / 1000000.0f;
+            _scheduler->updateSlicedJobs(std::max(0.0f, static_cast<float>(_animationInterval) - elapsed));
+        }
+    }
+
     // swap buffers
     if (_openGLView)
     {
@@ -448,6 +467,8 @@ void Director::initMatrixStack()
         _textureMatrixStack.pop();
     }
     
+    _visitedModelViews.clear();
+
     _modelViewMatrixStack.push(Mat4::IDENTITY);
     _projectionMatrixStack.push(Mat4::IDENTITY);
     _textureMatrixStack.push(Mat4::IDENTITY);
@@ -542,7 +563,8 @@ void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        _modelViewMatrixStack.push(_modelViewMatrixStack.top());
+        // the top may be the transform of a visited node that was only recorded
+        _modelViewMatrixStack.push(getMatrix(type));
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -563,7 +585,11 @@ Mat4 Director::getMatrix(MATRIX_STACK_TYPE type)
     Mat4 result;
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
-        result = _modelViewMatrixStack.top();
+        // a visited node transform is the top until something is pushed on the stack after it
+        if (!_visitedModelViews.empty() && _visitedModelViews.back().second == _modelViewMatrixStack.size())
+            result = *_visitedModelViews.back().first;
+        else
+            result = _modelViewMatrixStack.top();
     }
     else if(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION == type)
     {
@@ -590,6 +616,31 @@ Mat4 Director::getMatrix(MATRIX_STACK_TYPE type)
     return result;
 }
 
+void Director::pushModelViewTransform(const Mat4& modelView)
+{
+    if (_matrixStackEnabled)
+    {
+        _modelViewMatrixStack.push(modelView);
+    }
+    else
+    {
+        _visitedModelViews.push_back(std::make_pair(&modelView, _modelViewMatrixStack.size()));
+    }
+}
+
+void Director::popModelViewTransform()
+{
+    if (_matrixStackEnabled)
+    {
+        _modelViewMatrixStack.pop();
+    }
+    else
+    {
+        CCASSERT(!_visitedModelViews.empty(), "popModelViewTransform() without pushModelViewTransform()");
+        _visitedModelViews.pop_back();
+    }
+}
+
 void Director::setProjection(Projection projection)
 {
     Size size = _winSizeInPoints;
@@ -967,6 +1018,9 @@ void Director::purgeDirector()
 
     FontFreeType::shutdownFreeType();
 
+    // stop the background tasks before the caches they use go away
+    ThreadPool::destroyInstance();
+
     // purge all managed caches
     DrawPrimitives::free();
     AnimationCache::destroyInstance();
@@ -97,6 +97,10 @@ private:
     std::stack<Mat4> _modelViewMatrixStack;
     std::stack<Mat4> _projectionMatrixStack;
     std::stack<Mat4> _textureMatrixStack;
+    // transforms of the nodes being visited while the matrix stack is disabled,
+    // with the size of the model view stack when they were pushed
+    std::vector<std::pair<const Mat4*, size_t>> _visitedModelViews;
+    bool _matrixStackEnabled;
 protected:
     void initMatrixStack();
 public:
@@ -107,6 +111,24 @@ public:
     void multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat);
     Mat4 getMatrix(MATRIX_STACK_TYPE type);
     void resetMatrixStack();
+
+    /** Enables or disables the model view matrix stack while the scene is visited.
+     The stack is deprecated: when it is disabled the visited nodes only record a pointer to their transform,
+     instead of pushing a copy of it, and getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW) returns
+     the transform of the node being visited. Code that loads or multiplies the model view matrix
+     during a visit must push it first.
+     Enabled by default, don't change it during a visit.
+     @since v3.3
+     */
+    void setMatrixStackEnabled(bool enabled) { _matrixStackEnabled = enabled; }
+    bool isMatrixStackEnabled() const { return _matrixStackEnabled; }
+
+    /** Pushes the model view transform of the node being visited on the model view stack,
+     or only records it if the stack is disabled. The transform must stay valid until it is popped.
+     @since v3.3
+     */
+    void pushModelViewTransform(const Mat4& modelView);
+    void popModelViewTransform();
 public:
     static const char *EVENT_PROJECTION_CHANGED;
     static const char* EVENT_AFTER_UPDATE;
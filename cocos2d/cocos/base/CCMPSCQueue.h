@@ -0,0 +1,150 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCMPSCQUEUE_H__
+#define __BASE_CCMPSCQUEUE_H__
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief A lock-free queue many threads push into and one thread empties.
+
+ push() links a node on top of an atomic list with a compare-and-swap, it never waits for a lock held by
+ another thread. takeAll() detaches the whole list with a single exchange and hands the elements over
+ in the order they were pushed, so the consumer never blocks the producers either.
+
+ @since v3.3
+ */
+template <class T>
+class MPSCQueue
+{
+public:
+    MPSCQueue()
+    : _head(nullptr)
+    {
+    }
+
+    ~MPSCQueue()
+    {
+        deleteNodes(_head.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    /** Pushes a copy of value. It can be called from any thread. */
+    void push(const T& value)
+    {
+        pushNode(new Node(value));
+    }
+
+    /** Pushes value. It can be called from any thread. */
+    void push(T&& value)
+    {
+        pushNode(new Node(std::move(value)));
+    }
+
+    /** Moves the elements pushed so far to the end of 'out', the oldest first.
+     Returns the number of elements moved. Only the consumer thread should call it.
+     */
+    size_t takeAll(std::vector<T>& out)
+    {
+        Node* node = _head.exchange(nullptr, std::memory_order_acquire);
+
+        // the list is newest first, reverse it
+        Node* oldest = nullptr;
+        size_t count = 0;
+        while (node)
+        {
+            Node* next = node->next;
+            node->next = oldest;
+            oldest = node;
+            node = next;
+            ++count;
+        }
+
+        out.reserve(out.size() + count);
+        while (oldest)
+        {
+            Node* next = oldest->next;
+            out.push_back(std::move(oldest->value));
+            delete oldest;
+            oldest = next;
+        }
+
+        return count;
+    }
+
+    /** Whether nothing was pushed since the last takeAll(). The answer may be out of date as soon as it is returned. */
+    bool empty() const
+    {
+        return _head.load(std::memory_order_relaxed) == nullptr;
+    }
+
+private:
+    struct Node
+    {
+        explicit Node(const T& v) : value(v), next(nullptr) {}
+        explicit Node(T&& v) : value(std::move(v)), next(nullptr) {}
+
+        T value;
+        Node* next;
+    };
+
+    void pushNode(Node* node)
+    {
+        node->next = _head.load(std::memory_order_relaxed);
+        while (!_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static void deleteNodes(Node* node)
+    {
+        while (node)
+        {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    std::atomic<Node*> _head;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(MPSCQueue);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __BASE_CCMPSCQUEUE_H__
@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCObjectArena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+NS_CC_BEGIN
+
+ObjectArena* ObjectArena::getInstance()
+{
+    // never deleted: the objects of the arena may outlive the static destructors
+    static ObjectArena* s_instance = new ObjectArena();
+    return s_instance;
+}
+
+ObjectArena::ObjectArena()
+: _chunkCursor(nullptr)
+, _chunkLeft(0)
+{
+    memset(_freeLists, 0, sizeof(_freeLists));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void* ObjectArena::allocate(size_t size)
+{
+    if (size == 0 || size > MAX_OBJECT_SIZE)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.largeAllocations;
+        return malloc(size);
+    }
+
+    size_t sizeClass = (size - 1) / GRANULARITY;
+    size_t blockSize = (sizeClass + 1) * GRANULARITY;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_stats.allocations;
+    _stats.bytesInUse += blockSize;
+
+    FreeBlock* block = _freeLists[sizeClass];
+    if (block)
+    {
+        _freeLists[sizeClass] = block->next;
+        ++_stats.reuses;
+        return block;
+    }
+
+    if (_chunkLeft < blockSize)
+    {
+        // the end of the previous chunk is lost, it is smaller than the biggest block
+        char* chunk = static_cast<char*>(malloc(CHUNK_SIZE));
+        if (chunk == nullptr)
+        {
+            --_stats.allocations;
+            _stats.bytesInUse -= blockSize;
+            return nullptr;
+        }
+        _chunks.push_back(chunk);
+        _chunkCursor = chunk;
+        _chunkLeft = CHUNK_SIZE;
+        _stats.bytesReserved += CHUNK_SIZE;
+    }
+
+    void* ret = _chunkCursor;
+    _chunkCursor += blockSize;
+    _chunkLeft -= blockSize;
+    return ret;
+}
+
+void ObjectArena::deallocate(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    if (size == 0 || size > MAX_OBJECT_SIZE)
+    {
+        free(ptr);
+        return;
+    }
+
+    size_t sizeClass = (size - 1) / GRANULARITY;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = _freeLists[sizeClass];
+    _freeLists[sizeClass] = block;
+    _stats.bytesInUse -= (sizeClass + 1) * GRANULARITY;
+}
+
+ObjectArena::Stats ObjectArena::getStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void ObjectArena::resetStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.allocations = 0;
+    _stats.reuses = 0;
+    _stats.largeAllocations = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,135 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCOBJECTARENA_H__
+#define __BASE_CCOBJECTARENA_H__
+
+#include <new>
+#include <mutex>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief Allocates the small, short lived objects that are created and released every frame.
+
+ The memory is carved from large chunks and kept in free lists by size class: once the arena warmed up,
+ creating and releasing the objects of a frame doesn't call malloc and free anymore. The chunks are never
+ given back to the system.
+
+ A class opts in with CC_USE_OBJECT_ARENA(), the classes derived from it are allocated in the arena too:
+
+     class MyEffect : public Ref
+     {
+     public:
+         CC_USE_OBJECT_ARENA()
+         ...
+     };
+
+ @since v3.3
+ */
+class CC_DLL ObjectArena
+{
+public:
+    /** objects bigger than that are allocated with the global operator new */
+    static const size_t MAX_OBJECT_SIZE = 512;
+
+    struct Stats
+    {
+        /** number of allocations served by the arena */
+        ssize_t allocations;
+        /** number of those allocations that reused a freed block */
+        ssize_t reuses;
+        /** number of allocations too big for the arena */
+        ssize_t largeAllocations;
+        /** number of bytes of the blocks in use */
+        ssize_t bytesInUse;
+        /** number of bytes allocated from the system */
+        ssize_t bytesReserved;
+    };
+
+    static ObjectArena* getInstance();
+
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+
+    /** returns the statistics since the last resetStats() */
+    Stats getStats() const;
+    /** resets the counters, but not the bytes in use and reserved */
+    void resetStats();
+
+protected:
+    static const size_t GRANULARITY = 16;
+    static const size_t SIZE_CLASS_COUNT = MAX_OBJECT_SIZE / GRANULARITY;
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    ObjectArena();
+
+    FreeBlock* _freeLists[SIZE_CLASS_COUNT];
+    std::vector<char*> _chunks;
+    char* _chunkCursor;
+    size_t _chunkLeft;
+    Stats _stats;
+    mutable std::mutex _mutex;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ObjectArena);
+};
+
+/** Declares the allocation functions of a class that is allocated in the ObjectArena */
+#define CC_USE_OBJECT_ARENA() \
+    static void* operator new(size_t size) \
+    { \
+        return cocos2d::ObjectArena::getInstance()->allocate(size); \
+    } \
+    static void* operator new(size_t size, const std::nothrow_t&) throw() \
+    { \
+        return cocos2d::ObjectArena::getInstance()->allocate(size); \
+    } \
+    static void operator delete(void* ptr, size_t size) \
+    { \
+        cocos2d::ObjectArena::getInstance()->deallocate(ptr, size); \
+    } \
+    static void operator delete(void* ptr, const std::nothrow_t&) throw() \
+    { \
+        /* only called if a constructor throws, which cocos2d constructors don't: the block is leaked */ \
+    }
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __BASE_CCOBJECTARENA_H__
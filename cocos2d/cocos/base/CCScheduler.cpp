@@ -28,42 +28,22 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
+#include <algorithm>
+#include <chrono>
+
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
-{
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
 // Hash Element used for "selectors with interval"
 typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
+    double              pausedClock;    // scheduler clock when the target was paused
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
@@ -79,7 +59,28 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _deadline(0.0)
+, _lastFire(0.0)
+, _heapIndex(-1)
+, _sequence(0)
+, _armed(false)
+, _paused(false)
+, _scheduled(false)
+{
+}
+
+void Timer::setInterval(float interval)
 {
+    _interval = interval;
+
+    if (_armed && !_useDelay)
+    {
+        _deadline = _lastFire + _interval;
+        if (_heapIndex >= 0)
+        {
+            _scheduler->updateTimerInHeap(this);
+        }
+    }
 }
 
 void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float delay)
@@ -146,6 +147,42 @@ void Timer::update(float dt)
 }
 
 
+void Timer::arm(double now)
+{
+    _armed = true;
+    _timesExecuted = 0;
+    _lastFire = now;
+    _deadline = now + (_useDelay ? _delay : _interval);
+}
+
+void Timer::fire(double now)
+{
+    _elapsed = (float)(now - _lastFire);
+
+    trigger();
+
+    if (_useDelay)
+    {
+        // keep the time elapsed past the delay, as update() does
+        _lastFire += _delay;
+        _useDelay = false;
+    }
+    else
+    {
+        _lastFire = now;
+    }
+    _deadline = _lastFire + _interval;
+
+    if (!_runForever)
+    {
+        _timesExecuted += 1;
+        if (_timesExecuted > _repeat)
+        {    //unschedule timer
+            cancel();
+        }
+    }
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -247,20 +284,22 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
+, _updatesDirty(false)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _timerClock(0.0)
+, _timerSequence(0)
 , _updateHashLocked(false)
+, _timersLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _slicedJobsBudget(0.0f)
+, _slicedJobsLocked(false)
+, _functionsTakenIndex(0)
+, _performFunctionsBudget(0.0f)
 {
     // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    _functionsTaken.reserve(30);
 }
 
 Scheduler::~Scheduler(void)
@@ -275,6 +314,190 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+// timer heap
+
+void Scheduler::pushTimer(Timer *timer)
+{
+    _timerHeap.push_back(timer);
+    siftTimerUp(_timerHeap.size() - 1);
+}
+
+void Scheduler::removeTimerFromHeap(Timer *timer)
+{
+    ssize_t index = timer->_heapIndex;
+    CCASSERT(index >= 0 && index < (ssize_t)_timerHeap.size() && _timerHeap[index] == timer, "timer is not in the heap");
+
+    Timer *last = _timerHeap.back();
+    _timerHeap.pop_back();
+    timer->_heapIndex = -1;
+
+    if (last != timer)
+    {
+        _timerHeap[index] = last;
+        last->_heapIndex = index;
+        updateTimerInHeap(last);
+    }
+}
+
+void Scheduler::updateTimerInHeap(Timer *timer)
+{
+    ssize_t index = timer->_heapIndex;
+    if (index > 0 && timer->firesBefore(_timerHeap[(index - 1) / 2]))
+    {
+        siftTimerUp(index);
+    }
+    else
+    {
+        siftTimerDown(index);
+    }
+}
+
+void Scheduler::siftTimerUp(ssize_t index)
+{
+    Timer *timer = _timerHeap[index];
+    while (index > 0)
+    {
+        ssize_t parent = (index - 1) / 2;
+        if (! timer->firesBefore(_timerHeap[parent]))
+        {
+            break;
+        }
+        _timerHeap[index] = _timerHeap[parent];
+        _timerHeap[index]->_heapIndex = index;
+        index = parent;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
+void Scheduler::siftTimerDown(ssize_t index)
+{
+    ssize_t count = _timerHeap.size();
+    Timer *timer = _timerHeap[index];
+    while (true)
+    {
+        ssize_t child = index * 2 + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && _timerHeap[child + 1]->firesBefore(_timerHeap[child]))
+        {
+            ++child;
+        }
+        if (! _timerHeap[child]->firesBefore(timer))
+        {
+            break;
+        }
+        _timerHeap[index] = _timerHeap[child];
+        _timerHeap[index]->_heapIndex = index;
+        index = child;
+    }
+    _timerHeap[index] = timer;
+    timer->_heapIndex = index;
+}
+
+// timers of a target
+
+void Scheduler::addTimer(tHashTimerEntry *element, Timer *timer)
+{
+    ccArrayAppendObject(element->timers, timer);
+
+    // The timer is armed on the next tick, it starts counting from there like Timer::update does.
+    timer->_scheduled = true;
+    timer->_paused = element->paused;
+    timer->_armed = false;
+    timer->_deadline = _timerClock;
+    timer->_sequence = _timerSequence++;
+
+    if (! timer->_paused)
+    {
+        pushTimer(timer);
+    }
+}
+
+void Scheduler::removeTimerAtIndex(tHashTimerEntry *element, int index)
+{
+    Timer *timer = static_cast<Timer*>(element->timers->arr[index]);
+    timer->_scheduled = false;
+    if (timer->_heapIndex >= 0)
+    {
+        removeTimerFromHeap(timer);
+    }
+
+    // a timer being fired is retained by update(), it is safe to release it here
+    ccArrayRemoveObjectAtIndex(element->timers, index, true);
+
+    if (element->timers->num == 0)
+    {
+        removeHashElement(element);
+    }
+}
+
+void Scheduler::pauseTimers(tHashTimerEntry *element)
+{
+    if (element->paused)
+    {
+        return;
+    }
+
+    element->paused = true;
+    element->pausedClock = _timerClock;
+
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        timer->_paused = true;
+        if (timer->_heapIndex >= 0)
+        {
+            removeTimerFromHeap(timer);
+        }
+    }
+}
+
+void Scheduler::resumeTimers(tHashTimerEntry *element)
+{
+    if (! element->paused)
+    {
+        return;
+    }
+
+    element->paused = false;
+
+    // the time spent paused doesn't count
+    double pausedTime = _timerClock - element->pausedClock;
+
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        timer->_paused = false;
+
+        if (timer->_armed)
+        {
+            timer->_deadline += pausedTime;
+            timer->_lastFire += pausedTime;
+        }
+        else
+        {
+            timer->_deadline = _timerClock;
+        }
+
+        if (timer->_heapIndex < 0)
+        {
+            if (_timersLocked)
+            {
+                // don't let a timer fire twice in the same tick
+                timer->retain();
+                _timersToRearm.push_back(timer);
+            }
+            else
+            {
+                pushTimer(timer);
+            }
+        }
+    }
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, kRepeatForever, 0.0f, paused, key);
@@ -297,6 +520,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedClock = _timerClock;
     }
     else
     {
@@ -325,7 +549,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
     TimerTargetCallback *timer = new TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -351,158 +575,123 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
             if (key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-
+                removeTimerAtIndex(element, i);
                 return;
             }
         }
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
-{
-    tListEntry *listElement = new tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+// update entries
 
-    // empty list ?
-    if (! *list)
+Scheduler::UpdateEntry* Scheduler::findUpdateEntry(void *target)
+{
+    auto iter = _updateIndex.find(target);
+    if (iter != _updateIndex.end())
     {
-        DL_APPEND(*list, listElement);
+        return &_updateEntries[iter->second];
     }
-    else
-    {
-        bool added = false;
 
-        for (tListEntry *element = *list; element; element = element->next)
+    for (auto& entry : _updatesToAdd)
+    {
+        if (entry.target == target)
         {
-            if (priority < element->priority)
-            {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+            return &entry;
+        }
+    }
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
-                }
+    return nullptr;
+}
 
-                added = true;
-                break;
-            }
-        }
+void Scheduler::insertUpdateEntry(UpdateEntry&& entry)
+{
+    CCASSERT(!_updateHashLocked, "update entries can't be inserted while they are iterated");
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+    // after the entries with the same priority, so ties are called in scheduling order
+    auto pos = std::upper_bound(_updateEntries.begin(), _updateEntries.end(), entry.priority,
+                                [](int priority, const UpdateEntry& other) { return priority < other.priority; });
+    size_t index = pos - _updateEntries.begin();
+
+    _updateEntries.insert(pos, std::move(entry));
+
+    // most of the updates have priority 0 and land at the end, so few entries move
+    for (size_t i = index; i < _updateEntries.size(); ++i)
+    {
+        if (! _updateEntries[i].markedForDeletion)
         {
-            DL_APPEND(*list, listElement);
+            _updateIndex[_updateEntries[i].target] = i;
         }
     }
-
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+void Scheduler::flushUpdateEntries()
 {
-    tListEntry *listElement = new tListEntry();
+    if (_updatesDirty)
+    {
+        auto first = std::find_if(_updateEntries.begin(), _updateEntries.end(),
+                                  [](const UpdateEntry& entry) { return entry.markedForDeletion; });
+        size_t index = first - _updateEntries.begin();
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->markedForDeletion = false;
+        _updateEntries.erase(std::remove_if(first, _updateEntries.end(),
+                                            [](const UpdateEntry& entry) { return entry.markedForDeletion; }),
+                             _updateEntries.end());
 
-    DL_APPEND(*list, listElement);
+        for (size_t i = index; i < _updateEntries.size(); ++i)
+        {
+            _updateIndex[_updateEntries[i].target] = i;
+        }
 
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+        _updatesDirty = false;
+    }
+
+    if (! _updatesToAdd.empty())
+    {
+        std::vector<UpdateEntry> entries;
+        entries.swap(_updatesToAdd);
+        for (auto& entry : entries)
+        {
+            insertUpdateEntry(std::move(entry));
+        }
+    }
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    UpdateEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
         // check if priority has changed
-        if ((*hashElement->list)->priority != priority)
+        if (entry->priority != priority)
         {
             if (_updateHashLocked)
             {
                 CCLOG("warning: you CANNOT change update priority in scheduled function");
-                hashElement->entry->markedForDeletion = false;
-                hashElement->entry->paused = paused;
+                entry->paused = paused;
                 return;
             }
             else
             {
-            	// will be added again outside if (hashElement).
+            	// will be added again below.
                 unscheduleUpdate(target);
             }
         }
         else
         {
-            hashElement->entry->markedForDeletion = false;
-            hashElement->entry->paused = paused;
+            entry->paused = paused;
             return;
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
+    UpdateEntry newEntry = { callback, target, priority, paused, false };
+
+    // the update array can't change while it is iterated, the entry will be merged at the end of the tick
+    if (_updateHashLocked)
     {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
+        _updatesToAdd.push_back(std::move(newEntry));
     }
     else
     {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
+        insertUpdateEntry(std::move(newEntry));
     }
 }
 
@@ -541,42 +730,28 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
     return false;  // should never get here
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
+void Scheduler::unscheduleUpdate(void *target)
 {
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
+    if (target == nullptr)
     {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        CC_SAFE_DELETE(element->entry);
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
+        return;
     }
-}
 
-void Scheduler::unscheduleUpdate(void *target)
-{
-    if (target == nullptr)
+    // the entry is only marked, the array is compacted at the end of the tick
+    auto iter = _updateIndex.find(target);
+    if (iter != _updateIndex.end())
     {
+        _updateEntries[iter->second].markedForDeletion = true;
+        _updateIndex.erase(iter);
+        _updatesDirty = true;
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
+    auto pending = std::find_if(_updatesToAdd.begin(), _updatesToAdd.end(),
+                                [target](const UpdateEntry& entry) { return entry.target == target; });
+    if (pending != _updatesToAdd.end())
     {
-        if (_updateHashLocked)
-        {
-            element->entry->markedForDeletion = true;
-        }
-        else
-        {
-            this->removeUpdateFromHash(element->entry);
-        }
+        _updatesToAdd.erase(pending);
     }
 }
 
@@ -600,33 +775,28 @@ void Scheduler::unscheduleAllWithMinPriority(int minPriority)
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    auto first = std::lower_bound(_updateEntries.begin(), _updateEntries.end(), minPriority,
+                                  [](const UpdateEntry& entry, int priority) { return entry.priority < priority; });
+    for (auto iter = first; iter != _updateEntries.end(); ++iter)
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        if (! iter->markedForDeletion)
         {
-            if(entry->priority >= minPriority)
-            {
-                unscheduleUpdate(entry->target);
-            }
+            iter->markedForDeletion = true;
+            _updateIndex.erase(iter->target);
+            _updatesDirty = true;
         }
     }
 
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
+    _updatesToAdd.erase(std::remove_if(_updatesToAdd.begin(), _updatesToAdd.end(),
+                                       [minPriority](const UpdateEntry& entry) { return entry.priority >= minPriority; }),
+                        _updatesToAdd.end());
 
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // Sliced jobs have no priority, they are never system jobs
+    for (auto& job : _slicedJobs)
     {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        job.markedForDeletion = true;
     }
+    removeSlicedJobs();
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
 #endif
@@ -646,26 +816,31 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
+        for (int i = 0; i < element->timers->num; ++i)
         {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
+            Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+            timer->_scheduled = false;
+            if (timer->_heapIndex >= 0)
+            {
+                removeTimerFromHeap(timer);
+            }
         }
         ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
-        }
+        removeHashElement(element);
     }
 
     // update selector
     unscheduleUpdate(target);
+
+    // sliced jobs
+    for (auto& job : _slicedJobs)
+    {
+        if (job.target == target)
+        {
+            job.markedForDeletion = true;
+        }
+    }
+    removeSlicedJobs();
 }
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -700,16 +875,14 @@ void Scheduler::resumeTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "");
-        elementUpdate->entry->paused = false;
+        entry->paused = false;
     }
 }
 
@@ -722,16 +895,14 @@ void Scheduler::pauseTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "");
-        elementUpdate->entry->paused = true;
+        entry->paused = true;
     }
 }
 
@@ -748,11 +919,10 @@ bool Scheduler::isTargetPaused(void *target)
     }
     
     // We should check update selectors if target does not have custom selectors
-	tHashUpdateEntry *elementUpdate = nullptr;
-	HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-	if ( elementUpdate )
+    UpdateEntry *entry = findUpdateEntry(target);
+    if ( entry )
     {
-		return elementUpdate->entry->paused;
+        return entry->paused;
     }
     
     return false;  // should never get here
@@ -771,39 +941,28 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        pauseTimers(element);
         idsWithSelectors.insert(element->target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    auto first = std::lower_bound(_updateEntries.begin(), _updateEntries.end(), minPriority,
+                                  [](const UpdateEntry& entry, int priority) { return entry.priority < priority; });
+    for (auto iter = first; iter != _updateEntries.end(); ++iter)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        if (! iter->markedForDeletion)
         {
-            if(entry->priority >= minPriority)
-            {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
-            }
+            iter->paused = true;
+            idsWithSelectors.insert(iter->target);
         }
     }
 
-    if(minPriority <= 0)
+    for (auto& entry : _updatesToAdd)
     {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
+        if (entry.priority >= minPriority)
         {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
+            entry.paused = true;
+            idsWithSelectors.insert(entry.target);
         }
     }
 
@@ -817,128 +976,173 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
     }
 }
 
-void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
-{
-    _performMutex.lock();
-
-    _functionsToPerform.push_back(function);
-
-    _performMutex.unlock();
-}
-
-// main loop
-void Scheduler::update(float dt)
+void Scheduler::scheduleSlicedJob(const ccSlicedJobFunc& job, void *target, const std::string& key)
 {
-    _updateHashLocked = true;
+    CCASSERT(job, "Argument job must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
 
-    if (_timeScale != 1.0f)
+    if (isSlicedJobScheduled(key, target))
     {
-        dt *= _timeScale;
+        CCLOG("Scheduler#scheduleSlicedJob. Job %s already scheduled", key.c_str());
+        return;
     }
 
-    //
-    // Selector callbacks
-    //
-
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
+    SlicedJob slicedJob = { job, target, key, false };
+    _slicedJobs.push_back(std::move(slicedJob));
+}
 
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+void Scheduler::unscheduleSlicedJob(const std::string& key, void *target)
+{
+    for (auto& job : _slicedJobs)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        if (job.target == target && job.key == key && !job.markedForDeletion)
         {
-            entry->callback(dt);
+            job.markedForDeletion = true;
+            removeSlicedJobs();
+            return;
         }
     }
+}
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+bool Scheduler::isSlicedJobScheduled(const std::string& key, void *target)
+{
+    for (const auto& job : _slicedJobs)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        if (job.target == target && job.key == key && !job.markedForDeletion)
         {
-            entry->callback(dt);
+            return true;
         }
     }
+    return false;
+}
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+void Scheduler::removeSlicedJobs()
+{
+    // the running job stays in place, it is removed once it returns
+    if (_slicedJobsLocked)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
+        return;
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    _slicedJobs.erase(std::remove_if(_slicedJobs.begin(), _slicedJobs.end(),
+                                     [](const SlicedJob& job) { return job.markedForDeletion; }),
+                      _slicedJobs.end());
+}
+
+void Scheduler::updateSlicedJobs(float seconds)
+{
+    if (_slicedJobs.empty())
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        return;
+    }
 
-        if (! _currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+    if (_slicedJobsBudget > 0.0f && seconds > _slicedJobsBudget)
+    {
+        seconds = _slicedJobsBudget;
+    }
 
-                elt->currentTimer->update(dt);
+    auto start = std::chrono::steady_clock::now();
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+    _slicedJobsLocked = true;
 
-                elt->currentTimer = nullptr;
-            }
+    size_t index = 0;
+    do
+    {
+        while (index < _slicedJobs.size() && _slicedJobs[index].markedForDeletion)
+        {
+            ++index;
+        }
+        if (index == _slicedJobs.size())
+        {
+            break;
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+        // jobs scheduled by the slice are appended, this reference stays valid
+        SlicedJob& job = _slicedJobs[index];
+        if (job.job())
         {
-            removeHashElement(_currentTarget);
+            job.markedForDeletion = true;
         }
     }
+    while (std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() < seconds);
+
+    _slicedJobsLocked = false;
+
+    removeSlicedJobs();
+}
+
+void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
+{
+    _functionsToPerform.push(function);
+}
+
+// main loop
+void Scheduler::update(float dt)
+{
+    _updateHashLocked = true;
+
+    if (_timeScale != 1.0f)
+    {
+        dt *= _timeScale;
+    }
 
-    // delete all updates that are marked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    //
+    // Selector callbacks
+    //
+
+    // Iterate over all the Updates' selectors, they are sorted by priority.
+    // The array doesn't change while locked, new entries wait in _updatesToAdd.
+    for (size_t i = 0, count = _updateEntries.size(); i < count; ++i)
     {
-        if (entry->markedForDeletion)
+        UpdateEntry& entry = _updateEntries[i];
+        if ((! entry.paused) && (! entry.markedForDeletion))
         {
-            this->removeUpdateFromHash(entry);
+            entry.callback(dt);
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    // Fire the custom selectors that are due, the others are not visited
+    _timerClock += dt;
+    _timersLocked = true;
+
+    while (! _timerHeap.empty() && _timerHeap.front()->_deadline <= _timerClock)
     {
-        if (entry->markedForDeletion)
+        Timer *timer = _timerHeap.front();
+        removeTimerFromHeap(timer);
+
+        // The timer may be unscheduled by its own callback. To prevent it from
+        // accidentally deallocating itself before finishing its step, retain it.
+        timer->retain();
+
+        if (timer->_armed)
+        {
+            timer->fire(_timerClock);
+        }
+        else
         {
-            this->removeUpdateFromHash(entry);
+            timer->arm(_timerClock);
         }
+
+        // pushed back once the loop is done, so a timer fires at most once per tick
+        _timersToRearm.push_back(timer);
     }
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    _timersLocked = false;
+
+    for (auto timer : _timersToRearm)
     {
-        if (entry->markedForDeletion)
+        if (timer->_scheduled && ! timer->_paused && timer->_heapIndex < 0)
         {
-            this->removeUpdateFromHash(entry);
+            pushTimer(timer);
         }
+        timer->release();
     }
+    _timersToRearm.clear();
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
+
+    // delete all updates that are marked for deletion and add the ones scheduled during the tick
+    flushUpdateEntries();
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -966,18 +1170,35 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
+    // Testing emptiness is faster than taking the list.
     // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
+    if (! _functionsToPerform.empty())
+    {
+        _functionsToPerform.takeAll(_functionsTaken);
+    }
+
+    if (_functionsTakenIndex < _functionsTaken.size())
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // Functions posted while these run are taken on the next frame.
+        while (_functionsTakenIndex < _functionsTaken.size())
+        {
+            auto function = std::move(_functionsTaken[_functionsTakenIndex++]);
             function();
+
+            if (_performFunctionsBudget > 0.0f &&
+                std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= _performFunctionsBudget)
+            {
+                break;
+            }
+        }
+
+        if (_functionsTakenIndex == _functionsTaken.size())
+        {
+            _functionsTaken.clear();
+            _functionsTakenIndex = 0;
         }
-        
     }
 }
 
@@ -997,6 +1218,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
         
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedClock = _timerClock;
     }
     else
     {
@@ -1025,7 +1247,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     TimerTargetSelector *timer = new TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -1091,32 +1313,7 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
             
             if (selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-                
+                removeTimerAtIndex(element, i);
                 return;
             }
         }
@@ -28,12 +28,16 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/CCMPSCQueue.h"
 #include "base/uthash.h"
 
 NS_CC_BEGIN
@@ -46,6 +50,8 @@ NS_CC_BEGIN
 class Scheduler;
 
 typedef std::function<void(float)> ccSchedulerFunc;
+/** A slice of a sliced job, returns true once the job is finished. */
+typedef std::function<bool()> ccSlicedJobFunc;
 //
 // Timer
 //
@@ -59,7 +65,7 @@ public:
     /** get interval in seconds */
     inline float getInterval() const { return _interval; };
     /** set interval in seconds */
-    inline void setInterval(float interval) { _interval = interval; };
+    void setInterval(float interval);
     
     void setupTimerWithInterval(float seconds, unsigned int repeat, float delay);
     
@@ -70,6 +76,17 @@ public:
     void update(float dt);
     
 protected:
+    friend class Scheduler;
+
+    /** Starts counting from the scheduler clock 'now'. Used by Scheduler instead of update(). */
+    void arm(double now);
+    /** Triggers the timer at the scheduler clock 'now' and computes its next deadline. */
+    void fire(double now);
+    /** Heap order of the scheduler: earlier deadline first, then scheduling order. */
+    inline bool firesBefore(const Timer *other) const
+    {
+        return _deadline < other->_deadline || (_deadline == other->_deadline && _sequence < other->_sequence);
+    }
     
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -79,6 +96,15 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+
+    // Bookkeeping of the scheduler's timer heap
+    double _deadline;
+    double _lastFire;
+    ssize_t _heapIndex;       // -1 when the timer is not in the heap
+    unsigned int _sequence;   // keeps timers due at the same time in scheduling order
+    bool _armed;
+    bool _paused;
+    bool _scheduled;
 };
 
 
@@ -145,9 +171,7 @@ private:
 //
 // Scheduler
 //
-struct _listEntry;
 struct _hashSelectorEntry;
-struct _hashUpdateEntry;
 
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
@@ -359,10 +383,57 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe, and lock-free: it never waits for the cocos2d thread.
      @since v3.0
      */
     void performFunctionInCocosThread( const std::function<void()> &function);
+
+    /** Sets how long, in seconds, the functions posted with performFunctionInCocosThread may run per frame.
+     When the budget is spent the remaining functions are run on the next frames, in the same order.
+     At least one function is run per frame. 0, the default, runs all of them every frame.
+     @since v3.3
+     */
+    inline void setPerformFunctionsBudget(float seconds) { _performFunctionsBudget = seconds; }
+    /** @since v3.3 */
+    inline float getPerformFunctionsBudget() const { return _performFunctionsBudget; }
+
+    /////////////////////////////////////
+
+    // sliced jobs
+
+    /** Schedules a long job to be run in slices, with the time left at the end of the frames.
+     'job' is called repeatedly. Each call should do a small amount of work, and return true once the job is finished.
+     The jobs run one after the other, in the order they were scheduled.
+     If a job is already scheduled for 'key' and 'target', nothing happens.
+     @since v3.3
+     */
+    void scheduleSlicedJob(const ccSlicedJobFunc& job, void *target, const std::string& key);
+
+    /** Unschedules the sliced job of 'key' and 'target'. unscheduleAllForTarget unschedules them too.
+     @since v3.3
+     */
+    void unscheduleSlicedJob(const std::string& key, void *target);
+
+    /** Checks whether a sliced job associated with 'key' and 'target' is scheduled.
+     @since v3.3
+     */
+    bool isSlicedJobScheduled(const std::string& key, void *target);
+
+    /** Runs slices of the sliced jobs for up to 'seconds', capped by the sliced jobs budget.
+     At least one slice runs, so the jobs progress even when the frame has no time left.
+     The Director calls it with the time left in the frame after update and render.
+     * @js NA
+     * @lua NA
+     * @since v3.3
+     */
+    void updateSlicedJobs(float seconds);
+
+    /** Sets the most time, in seconds, the sliced jobs may take per frame. 0, the default, lets them use all the time left in the frame.
+     @since v3.3
+     */
+    inline void setSlicedJobsBudget(float seconds) { _slicedJobsBudget = seconds; }
+    /** @since v3.3 */
+    inline float getSlicedJobsBudget() const { return _slicedJobsBudget; }
     
     /////////////////////////////////////
     
@@ -419,6 +490,7 @@ public:
     CC_DEPRECATED_ATTRIBUTE void unscheduleUpdateForTarget(Ref *target) { return unscheduleUpdate(target); };
     
 protected:
+    friend class Timer;
     
     /** Schedules the 'callback' function for a given target with a given priority.
      The 'callback' selector will be called every frame.
@@ -429,12 +501,38 @@ protected:
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
     void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
 
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    struct UpdateEntry
+    {
+        ccSchedulerFunc callback;
+        void *target;
+        int priority;
+        bool paused;
+        bool markedForDeletion; // entry will no longer be called and will be removed at the end of the tick
+    };
+
+    UpdateEntry* findUpdateEntry(void *target);
+    void insertUpdateEntry(UpdateEntry&& entry);
+    void flushUpdateEntries();
+
+    // timer specific
+
+    void addTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void removeTimerAtIndex(struct _hashSelectorEntry *element, int index);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+
+    void pushTimer(Timer *timer);
+    void removeTimerFromHeap(Timer *timer);
+    void updateTimerInHeap(Timer *timer);
+    void siftTimerUp(ssize_t index);
+    void siftTimerDown(ssize_t index);
+
+    // sliced jobs specific
+
+    void removeSlicedJobs();
 
 
     float _timeScale;
@@ -442,25 +540,54 @@ protected:
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
+    // Entries are kept in one contiguous array sorted by priority, so negative, zero
+    // and positive priorities are consecutive buckets of it. Unscheduled entries stay
+    // in place, marked for deletion, until the array is compacted at the end of the tick.
+    std::vector<UpdateEntry> _updateEntries;
+    // index of the live entry of each target in _updateEntries
+    std::unordered_map<void*, size_t> _updateIndex;
+    // entries scheduled while the array is being iterated, merged at the end of the tick
+    std::vector<UpdateEntry> _updatesToAdd;
+    bool _updatesDirty;
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
+    // Min-heap of the running timers ordered by deadline. A frame only visits the
+    // timers that are due, idle and paused timers cost nothing.
+    std::vector<Timer*> _timerHeap;
+    // timers fired this tick, pushed back into the heap once the tick is done
+    std::vector<Timer*> _timersToRearm;
+    double _timerClock;
+    unsigned int _timerSequence;
+    // If true unschedule will not remove anything from the update array. Elements will only be marked for deletion.
     bool _updateHashLocked;
+    // If true the due timers are being fired, resumed timers wait in _timersToRearm.
+    bool _timersLocked;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
     
+    // Used for sliced jobs
+    struct SlicedJob
+    {
+        ccSlicedJobFunc job;
+        void *target;
+        std::string key;
+        bool markedForDeletion;
+    };
+    // a deque, so the running job stays in place when new ones are scheduled
+    std::deque<SlicedJob> _slicedJobs;
+    float _slicedJobsBudget;
+    // If true the sliced jobs are running, unscheduled jobs are only marked for deletion
+    bool _slicedJobsLocked;
+
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    MPSCQueue<std::function<void()>> _functionsToPerform;
+    // functions taken from the queue, only touched by the cocos2d thread
+    std::vector<std::function<void()>> _functionsTaken;
+    size_t _functionsTakenIndex;
+    float _performFunctionsBudget;
 };
 
 // end of global group
@@ -0,0 +1,351 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCThreadPool.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+enum
+{
+    TASK_PENDING,
+    TASK_RUNNING,
+    TASK_DONE,
+    TASK_CANCELLED,
+};
+
+struct ThreadPool::Task::State
+{
+    State(const std::function<void()>& w)
+    : work(w)
+    , scheduler(nullptr)
+    , status(TASK_PENDING)
+    , cancelled(false)
+    {
+    }
+
+    std::function<void()> work;
+    // the scheduler of the thread that submitted the task, continuations are posted to it
+    Scheduler* scheduler;
+    std::function<void()> continuation;
+    std::atomic<int> status;
+    // set by cancel() even when the work already ran, so the continuation is skipped
+    std::atomic<bool> cancelled;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+// Task
+
+ThreadPool::Task::Task()
+{
+}
+
+ThreadPool::Task::Task(const std::shared_ptr<State>& state)
+: _state(state)
+{
+}
+
+bool ThreadPool::Task::cancel()
+{
+    if (!_state)
+    {
+        return false;
+    }
+
+    _state->cancelled = true;
+
+    int expected = TASK_PENDING;
+    if (_state->status.compare_exchange_strong(expected, TASK_CANCELLED))
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        _state->work = nullptr;
+        _state->continuation = nullptr;
+        _state->condition.notify_all();
+        return true;
+    }
+
+    return false;
+}
+
+bool ThreadPool::Task::isCancelled() const
+{
+    return _state && _state->cancelled;
+}
+
+bool ThreadPool::Task::isDone() const
+{
+    return _state && _state->status == TASK_DONE;
+}
+
+void ThreadPool::Task::wait() const
+{
+    if (!_state)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_state->mutex);
+    _state->condition.wait(lock, [this](){
+        int status = _state->status;
+        return status == TASK_DONE || status == TASK_CANCELLED;
+    });
+}
+
+ThreadPool::Task& ThreadPool::Task::then(const std::function<void()>& callback)
+{
+    CCASSERT(_state, "Invalid task");
+
+    std::unique_lock<std::mutex> lock(_state->mutex);
+    int status = _state->status;
+    if (status == TASK_DONE)
+    {
+        lock.unlock();
+        postContinuation(_state, callback);
+    }
+    else if (status != TASK_CANCELLED)
+    {
+        _state->continuation = callback;
+    }
+
+    return *this;
+}
+
+void ThreadPool::Task::postContinuation(const std::shared_ptr<State>& state, const std::function<void()>& continuation)
+{
+    state->scheduler->performFunctionInCocosThread([state, continuation](){
+        // cancel() is called on the cocos2d thread too, no need to synchronize
+        if (!state->cancelled)
+        {
+            continuation();
+        }
+    });
+}
+
+// ThreadPool
+
+static ThreadPool* s_sharedThreadPool = nullptr;
+static std::mutex s_sharedThreadPoolMutex;
+static int s_defaultThreadCount = 0;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+    if (s_sharedThreadPool == nullptr)
+    {
+        int threadCount = s_defaultThreadCount;
+        if (threadCount <= 0)
+        {
+            threadCount = std::max(2, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        }
+        s_sharedThreadPool = new (std::nothrow) ThreadPool(threadCount);
+    }
+    return s_sharedThreadPool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    std::lock_guard<std::mutex> lock(s_sharedThreadPoolMutex);
+    CC_SAFE_DELETE(s_sharedThreadPool);
+}
+
+void ThreadPool::setDefaultThreadCount(int threadCount)
+{
+    s_defaultThreadCount = threadCount;
+}
+
+ThreadPool::ThreadPool(int threadCount)
+: _nextWorker(0)
+, _pendingCount(0)
+, _quit(false)
+{
+    CCASSERT(threadCount > 0, "A thread pool needs at least one thread");
+
+    _workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        _workers.push_back(new Worker());
+    }
+
+    // started once every worker exists, since they steal from each other
+    for (size_t i = 0; i < _workers.size(); ++i)
+    {
+        _workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto worker : _workers)
+    {
+        worker->thread.join();
+    }
+
+    // cancel what didn't start, so nobody waits for it forever
+    for (auto worker : _workers)
+    {
+        for (auto& queue : worker->queues)
+        {
+            for (auto& state : queue)
+            {
+                Task(state).cancel();
+            }
+        }
+        delete worker;
+    }
+    _workers.clear();
+}
+
+ThreadPool::Task ThreadPool::submit(const std::function<void()>& work, Priority priority)
+{
+    auto state = std::make_shared<Task::State>(work);
+
+    int index = findWorker();
+    if (index < 0)
+    {
+        index = _nextWorker++ % _workers.size();
+        state->scheduler = Director::getInstance()->getScheduler();
+    }
+    else
+    {
+        // submitted from a task, the Director must not be touched from a worker
+        state->scheduler = _workers[index]->scheduler;
+    }
+
+    Worker* worker = _workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[static_cast<int>(priority)].push_back(state);
+    }
+
+    {
+        // taking the lock makes sure a worker about to sleep sees the new task
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        ++_pendingCount;
+    }
+    _sleepCondition.notify_one();
+
+    return Task(state);
+}
+
+int ThreadPool::findWorker() const
+{
+    auto threadId = std::this_thread::get_id();
+    for (size_t i = 0; i < _workers.size(); ++i)
+    {
+        if (_workers[i]->thread.get_id() == threadId)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::shared_ptr<ThreadPool::Task::State> ThreadPool::takeTask(size_t index)
+{
+    size_t count = _workers.size();
+
+    for (int priority = 0; priority < PRIORITY_COUNT; ++priority)
+    {
+        // own queue first, then steal from the others, always the oldest task
+        for (size_t i = 0; i < count; ++i)
+        {
+            Worker* worker = _workers[(index + i) % count];
+            std::lock_guard<std::mutex> lock(worker->mutex);
+
+            auto& queue = worker->queues[priority];
+            if (!queue.empty())
+            {
+                auto state = std::move(queue.front());
+                queue.pop_front();
+                --_pendingCount;
+                return state;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::run(size_t index)
+{
+    Worker* self = _workers[index];
+
+    while (true)
+    {
+        // the tasks left in the queues are cancelled by the destructor
+        if (_quit)
+        {
+            break;
+        }
+
+        auto state = takeTask(index);
+        if (!state)
+        {
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleepCondition.wait(lock, [this](){ return _quit || _pendingCount > 0; });
+            if (_quit)
+            {
+                break;
+            }
+            continue;
+        }
+
+        int expected = TASK_PENDING;
+        if (!state->status.compare_exchange_strong(expected, TASK_RUNNING))
+        {
+            // cancelled
+            continue;
+        }
+
+        self->scheduler = state->scheduler;
+        state->work();
+        self->scheduler = nullptr;
+
+        {
+            // posted before the task is marked done, so that once wait() returns nothing touches the scheduler
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->continuation)
+            {
+                Task::postContinuation(state, state->continuation);
+                state->continuation = nullptr;
+            }
+            state->work = nullptr;
+            state->status = TASK_DONE;
+            state->condition.notify_all();
+        }
+    }
+}
+
+NS_CC_END
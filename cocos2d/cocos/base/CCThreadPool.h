@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCTHREADPOOL_H__
+#define __BASE_CCTHREADPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Scheduler;
+
+/**
+ * @addtogroup base_nodes
+ * @{
+ */
+
+/** @brief A pool of worker threads shared by the engine for background work.
+
+ Each worker has its own queues, one per priority. A task submitted from a worker goes to that worker's
+ queues, the others are spread across the workers. An idle worker takes the oldest of the most urgent tasks
+ it can find, from its own queues first, then steals from the other workers.
+
+ A continuation attached with Task::then() is called on the cocos2d thread, through
+ Scheduler::performFunctionInCocosThread of the Director's scheduler at submit time, once the work is done:
+
+     auto image = std::make_shared<Image*>(nullptr);
+     ThreadPool::getInstance()->submit([=](){
+         *image = loadImage(path);
+     }).then([=](){
+         useImage(*image);
+     });
+
+ @since v3.3
+ */
+class CC_DLL ThreadPool
+{
+public:
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    /** A handle to a submitted task, it can be copied. */
+    class CC_DLL Task
+    {
+    public:
+        Task();
+
+        /** Whether the handle refers to a task. */
+        bool isValid() const { return _state != nullptr; }
+
+        /** Cancels the task. Its continuation won't be called.
+         Returns true if the work didn't start and will never run, false if it is running or already ran.
+         */
+        bool cancel();
+
+        /** Whether cancel() was called. */
+        bool isCancelled() const;
+
+        /** Whether the work ran to completion. */
+        bool isDone() const;
+
+        /** Blocks until the work is done or the task is cancelled. Never call it from a worker of the pool.
+         When it returns, the continuation, if any, is already posted to the scheduler.
+         */
+        void wait() const;
+
+        /** Calls callback on the cocos2d thread once the work is done, unless the task was cancelled.
+         Only one continuation is kept, a second call replaces the first one.
+         */
+        Task& then(const std::function<void()>& callback);
+
+    private:
+        friend class ThreadPool;
+        struct State;
+
+        explicit Task(const std::shared_ptr<State>& state);
+
+        static void postContinuation(const std::shared_ptr<State>& state, const std::function<void()>& continuation);
+
+        std::shared_ptr<State> _state;
+    };
+
+    /** Returns the pool shared by the engine, creating it the first time. */
+    static ThreadPool* getInstance();
+
+    /** Stops the shared pool. The tasks that didn't start are cancelled. */
+    static void destroyInstance();
+
+    /** Sets the number of threads of the shared pool, it is read when the pool is created.
+     0, the default, uses one thread per core but one, and at least two threads.
+     */
+    static void setDefaultThreadCount(int threadCount);
+
+    /** Creates a pool with 'threadCount' workers. */
+    explicit ThreadPool(int threadCount);
+
+    /** Waits for the running tasks to finish. The tasks that didn't start are cancelled. */
+    ~ThreadPool();
+
+    /** Queues work to be run on a worker. It can be called from any thread. */
+    Task submit(const std::function<void()>& work, Priority priority = Priority::NORMAL);
+
+    /** Number of worker threads. */
+    int getThreadCount() const { return static_cast<int>(_workers.size()); }
+
+    /** Index of the calling worker, in [0, getThreadCount()), or -1 if it is called from another thread. */
+    int getWorkerIndex() const { return findWorker(); }
+
+private:
+    static const int PRIORITY_COUNT = 3;
+
+    struct Worker
+    {
+        Worker() : scheduler(nullptr) {}
+
+        std::thread thread;
+        Scheduler* scheduler;   ///< scheduler of the task being run, inherited by the tasks it submits
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Task::State>> queues[PRIORITY_COUNT];
+    };
+
+    void run(size_t index);
+    std::shared_ptr<Task::State> takeTask(size_t index);
+    int findWorker() const;
+
+    std::vector<Worker*> _workers;
+    std::atomic<unsigned int> _nextWorker;
+    std::atomic<int> _pendingCount;
+    std::atomic<bool> _quit;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+// end of base_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __BASE_CCTHREADPOOL_H__
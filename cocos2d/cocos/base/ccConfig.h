@@ -151,6 +151,27 @@ Only valid for cocos2d-mac. Not supported on cocos2d-ios.
 #define CC_NODE_RENDER_SUBPIXEL 1
 #endif
 
+/** @def CC_PARALLEL_VISIT_MAX_THREADS
+ Maximum number of ThreadPool workers used to visit the children of nodes that have parallel visit enabled
+ (see Node::setParallelVisitEnabled). The main thread is not included.
+ The number of threads of the shared ThreadPool is used if it is lower.
+ 
+ Defaults to 3. Set it to 0 to always visit the children from the main thread.
+ */
+#ifndef CC_PARALLEL_VISIT_MAX_THREADS
+#define CC_PARALLEL_VISIT_MAX_THREADS 3
+#endif
+
+/** @def CC_PARALLEL_VISIT_MIN_NODES_PER_THREAD
+ Child lists are only split across threads when each thread gets at least this many children,
+ since waking up the workers is not free.
+ 
+ Defaults to 128.
+ */
+#ifndef CC_PARALLEL_VISIT_MIN_NODES_PER_THREAD
+#define CC_PARALLEL_VISIT_MIN_NODES_PER_THREAD 128
+#endif
+
 /** @def CC_SPRITEBATCHNODE_RENDER_SUBPIXEL
  If enabled, the Sprite objects rendered with SpriteBatchNode will be able to render in subpixels.
  If disabled, integer pixels will be used.
@@ -180,6 +201,21 @@ Only valid for cocos2d-mac. Not supported on cocos2d-ios.
     #endif
 #endif
 
+/** @def CC_ENABLE_PROGRAM_BINARY_CACHE
+ If enabled, the linked binaries of the default shaders are saved in the writable path, and loaded
+ instead of compiling the shaders the next time the application starts.
+ Only used when the driver supports GL_OES_get_program_binary or GL_ARB_get_program_binary.
+ The binaries are keyed by the shader sources and the driver strings, so driver updates invalidate them.
+
+ Enabled by default on Android, Windows and Linux. iOS and Mac don't support program binaries.
+ */
+#ifndef CC_ENABLE_PROGRAM_BINARY_CACHE
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        #define CC_ENABLE_PROGRAM_BINARY_CACHE 1
+    #else
+        #define CC_ENABLE_PROGRAM_BINARY_CACHE 0
+    #endif
+#endif
 
 /** @def CC_USE_LA88_LABELS
  If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for LabelTTF objects.
@@ -184,6 +184,42 @@ double atof(const char* str)
     
     return ::atof(buf);
 }
+
+bool isAxisAligned(const Mat4& modelView)
+{
+    // x and y must not depend on each other, and z must not depend on them (no tilt)
+    return fabsf(modelView.m[1]) < FLT_EPSILON && fabsf(modelView.m[4]) < FLT_EPSILON
+        && fabsf(modelView.m[2]) < FLT_EPSILON && fabsf(modelView.m[6]) < FLT_EPSILON
+        && fabsf(modelView.m[3]) < FLT_EPSILON && fabsf(modelView.m[7]) < FLT_EPSILON;
+}
+
+Rect getWindowRect(const Mat4& modelView, const Rect& rect)
+{
+    Mat4 mvp = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * modelView;
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    const Vec2 corners[2] = { rect.origin, Vec2(rect.getMaxX(), rect.getMaxY()) };
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (const auto& corner : corners)
+    {
+        Vec4 clip(corner.x, corner.y, 0, 1);
+        mvp.transformVector(&clip);
+        if (clip.w <= 0)
+            return Rect::ZERO;
+
+        float x = viewport[0] + (clip.x / clip.w + 1) * 0.5f * viewport[2];
+        float y = viewport[1] + (clip.y / clip.w + 1) * 0.5f * viewport[3];
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    minX = floorf(minX + 0.5f);
+    minY = floorf(minY + 0.5f);
+    return Rect(minX, minY, floorf(maxX + 0.5f) - minX, floorf(maxY + 0.5f) - minY);
+}
     
 }
 
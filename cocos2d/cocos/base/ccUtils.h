@@ -78,6 +78,18 @@ namespace utils
      *  Why we need this? Because in android c++_static, atof ( and std::atof ) is unsupported for numbers have long decimal part and contain several numbers can approximate to 1 （ like 90.099998474121094 ), it will return inf. this function is used to fix this bug.
      */
     double atof(const char* str);
+
+    /** Returns whether a rectangle of the xy plane, transformed by modelView, stays an axis aligned
+     rectangle on screen, i.e. the transform has no rotation, skew or tilt.
+     @since v3.3
+     */
+    bool isAxisAligned(const Mat4& modelView);
+
+    /** Returns the window rectangle, in pixels, covered by a rectangle of the xy plane given in the space of modelView.
+     It uses the projection matrix and the viewport that are current, so it must be called while rendering.
+     @since v3.3
+     */
+    Rect getWindowRect(const Mat4& modelView, const Rect& rect);
 }
 
 NS_CC_END
@@ -43,6 +43,9 @@ THE SOFTWARE.
 #include "base/CCVector.h"
 #include "base/CCMap.h"
 #include "base/CCAutoreleasePool.h"
+#include "base/CCObjectArena.h"
+#include "base/CCMPSCQueue.h"
+#include "base/CCThreadPool.h"
 #include "base/CCNS.h"
 #include "base/CCData.h"
 #include "base/CCValue.h"
@@ -107,6 +110,8 @@ THE SOFTWARE.
 
 // 2d nodes
 #include "2d/CCNode.h"
+#include "2d/CCNodePath.h"
+#include "2d/CCNodePool.h"
 #include "2d/CCAtlasNode.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCDrawNode.h"
@@ -141,11 +146,15 @@ THE SOFTWARE.
 
 // renderer
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCDebugDrawBatch.h"
+#include "renderer/CCDynamicAtlas.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCQuadCommand.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderCapture.h"
+#include "renderer/CCRenderStats.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
@@ -239,6 +248,8 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCStaticBatchNode.h"
+#include "2d/CCSpatialIndexNode.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
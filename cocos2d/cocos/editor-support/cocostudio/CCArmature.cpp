@@ -472,8 +472,7 @@ void Armature::visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, u
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewTransform(_modelViewTransform);
 
 
     sortAllChildren();
@@ -482,7 +481,7 @@ void Armature::visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, u
     // reset for next frame
     _orderOfArrival = 0;
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewTransform();
 }
 
 Rect Armature::getBoundingBox() const
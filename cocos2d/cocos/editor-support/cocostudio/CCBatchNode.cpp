@@ -119,8 +119,7 @@ void BatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewTransform(_modelViewTransform);
 
     sortAllChildren();
     draw(renderer, _modelViewTransform, flags);
@@ -128,7 +127,7 @@ void BatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t
     // reset for next frame
     _orderOfArrival = 0;
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewTransform();
 }
 
 void BatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
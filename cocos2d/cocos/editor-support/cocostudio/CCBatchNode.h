@@ -57,6 +57,7 @@ public:
     virtual void addChild(cocos2d::Node *pChild, int zOrder, const std::string &name) override;
     virtual void removeChild(cocos2d::Node* child, bool cleanup) override;
     virtual void visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
     virtual void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, uint32_t flags) override;
     
 protected:
@@ -152,67 +152,22 @@ DataReaderHelper *DataReaderHelper::_dataReaderHelper = nullptr;
 
 
 
-//! Async load
-void DataReaderHelper::loadData()
+//! Async load, runs on the ThreadPool
+void DataReaderHelper::loadData(DataInfo *dataInfo)
 {
-    AsyncStruct *pAsyncStruct = nullptr;
+    AsyncStruct *pAsyncStruct = dataInfo->asyncStruct;
 
-    while (true)
+    if (pAsyncStruct->configType == DragonBone_XML)
     {
-        std::queue<AsyncStruct *> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock(); // get async struct from queue
-        if (pQueue->empty())
-        {
-            _asyncStructQueueMutex.unlock();
-            if (need_quit)
-            {
-                break;
-            }
-            else
-            {
-				std::unique_lock<std::mutex> lk(_sleepMutex);
-				_sleepCondition.wait(lk);
-                continue;
-            }
-        }
-        else
-        {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }
-
-        // generate data info
-        DataInfo *pDataInfo = new DataInfo();
-        pDataInfo->asyncStruct = pAsyncStruct;
-        pDataInfo->filename = pAsyncStruct->filename;
-        pDataInfo->baseFilePath = pAsyncStruct->baseFilePath;
-
-        if (pAsyncStruct->configType == DragonBone_XML)
-        {
-            DataReaderHelper::addDataFromCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
-        }
-        else if(pAsyncStruct->configType == CocoStudio_JSON)
-        {
-            DataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
-        }
-        else if(pAsyncStruct->configType == CocoStudio_Binary)
-        {
-            DataReaderHelper::addDataFromBinaryCache(pAsyncStruct->fileContent.c_str(),pDataInfo);
-        }
-
-        // put the image info into the queue
-        _dataInfoMutex.lock();
-        _dataQueue->push(pDataInfo);
-        _dataInfoMutex.unlock();
+        DataReaderHelper::addDataFromCache(pAsyncStruct->fileContent.c_str(), dataInfo);
     }
-
-    if( _asyncStructQueue != nullptr )
+    else if(pAsyncStruct->configType == CocoStudio_JSON)
     {
-        delete _asyncStructQueue;
-        _asyncStructQueue = nullptr;
-        delete _dataQueue;
-        _dataQueue = nullptr;
+        DataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent.c_str(), dataInfo);
+    }
+    else if(pAsyncStruct->configType == CocoStudio_Binary)
+    {
+        DataReaderHelper::addDataFromBinaryCache(pAsyncStruct->fileContent.c_str(), dataInfo);
     }
 }
 
@@ -246,24 +201,26 @@ void DataReaderHelper::purge()
 
 
 DataReaderHelper::DataReaderHelper()
-	: _loadingThread(nullptr)
-	, _asyncRefCount(0)
+	: _asyncRefCount(0)
 	, _asyncRefTotalCount(0)
-	, need_quit(false)
-	, _asyncStructQueue(nullptr)
-	, _dataQueue(nullptr)
 {
 
 }
 
 DataReaderHelper::~DataReaderHelper()
 {
-    need_quit = true;
+    // drop the pending loads, wait for the ones being parsed
+    for (auto dataInfo : _dataQueue)
+    {
+        dataInfo->task.cancel();
+        dataInfo->task.wait();
 
-	_sleepCondition.notify_one();
-	if (_loadingThread) _loadingThread->join();
+        CC_SAFE_RELEASE(dataInfo->asyncStruct->target);
+        delete dataInfo->asyncStruct;
+        delete dataInfo;
+    }
+    _dataQueue.clear();
 
-	CC_SAFE_DELETE(_loadingThread);
 	_dataReaderHelper = nullptr;
 }
 
@@ -372,23 +329,6 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     }
 
 
-    // lazy init
-    if (_asyncStructQueue == nullptr)
-    {
-        _asyncStructQueue = new std::queue<AsyncStruct *>();
-        _dataQueue = new std::queue<DataInfo *>();
-
-		// create a new thread to load images
-		_loadingThread = new std::thread(&DataReaderHelper::loadData, this);
-
-        need_quit = false;
-    }
-
-    if (0 == _asyncRefCount)
-    {
-        Director::getInstance()->getScheduler()->schedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this, 0, false);
-    }
-
     ++_asyncRefCount;
     ++_asyncRefTotalCount;
 
@@ -445,29 +385,31 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     }
 
 
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    // generate data info
+    DataInfo *pDataInfo = new DataInfo();
+    pDataInfo->asyncStruct = data;
+    pDataInfo->filename = data->filename;
+    pDataInfo->baseFilePath = data->baseFilePath;
+    pDataInfo->loaded = false;
+
+    pDataInfo->task = ThreadPool::getInstance()->submit([pDataInfo](){
+        DataReaderHelper::loadData(pDataInfo);
+    });
+    pDataInfo->task.then([this, pDataInfo](){
+        pDataInfo->loaded = true;
+        addDataAsyncCallBack(0);
+    });
 
-    _sleepCondition.notify_one();
+    _dataQueue.push_back(pDataInfo);
 }
 
 void DataReaderHelper::addDataAsyncCallBack(float dt)
 {
-    // the data is generated in loading thread
-    std::queue<DataInfo *> *dataQueue = _dataQueue;
-
-    _dataInfoMutex.lock();
-    if (dataQueue->empty())
-    {
-        _dataInfoMutex.unlock();
-    }
-    else
+    // the data is generated on the ThreadPool, it is delivered in the order it was requested
+    while (!_dataQueue.empty() && _dataQueue.front()->loaded)
     {
-        DataInfo *pDataInfo = dataQueue->front();
-        dataQueue->pop();
-        _dataInfoMutex.unlock();
+        DataInfo *pDataInfo = _dataQueue.front();
+        _dataQueue.pop_front();
 
         AsyncStruct *pAsyncStruct = pDataInfo->asyncStruct;
 
@@ -507,7 +449,6 @@ void DataReaderHelper::addDataAsyncCallBack(float dt)
         if (0 == _asyncRefCount)
         {
             _asyncRefTotalCount = 0;
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(DataReaderHelper::addDataAsyncCallBack), this);
         }
     }
 }
@@ -33,12 +33,13 @@ THE SOFTWARE.
 #include "json/document.h"
 #include "DictionaryHelper.h"
 
+#include "base/CCThreadPool.h"
+
 #include <string>
 #include <queue>
+#include <deque>
 #include <list>
 #include <mutex>
-#include <thread>
-#include <condition_variable>
 
 namespace tinyxml2
 {
@@ -86,6 +87,8 @@ protected:
         std::string    baseFilePath;
         float flashToolVersion;
         float cocoStudioVersion;
+        bool loaded;
+        cocos2d::ThreadPool::Task task;
 	} DataInfo;
 
 public:
@@ -195,19 +198,7 @@ public:
 	static void decodeNode(BaseData *node, CocoLoader *cocoLoader, stExpCocoNode *pCocoNode, DataInfo *dataInfo);
     
 protected:
-	void loadData();
-
-
-
-
-	std::condition_variable		_sleepCondition;
-
-	std::thread     *_loadingThread;
-
-	std::mutex      _sleepMutex;
-
-	std::mutex      _asyncStructQueueMutex;
-	std::mutex      _dataInfoMutex;
+	static void loadData(DataInfo *dataInfo);
 
 	std::mutex      _addDataMutex;
 
@@ -217,10 +208,8 @@ protected:
 	unsigned long _asyncRefCount;
 	unsigned long _asyncRefTotalCount;
 
-	bool need_quit;
-
-	std::queue<AsyncStruct *> *_asyncStructQueue;
-	std::queue<DataInfo *>   *_dataQueue;
+	// loads in the order they were requested, only touched by the cocos2d thread
+	std::deque<DataInfo *>   _dataQueue;
 
     static std::vector<std::string> _configFileList;
 
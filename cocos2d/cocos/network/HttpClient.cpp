@@ -26,15 +26,15 @@
 
 #include "HttpClient.h"
 
-#include <thread>
 #include <queue>
-#include <condition_variable>
+#include <mutex>
 
 #include <errno.h>
 
 #include "base/CCVector.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
 
 #include "curl/curl.h"
 
@@ -47,15 +47,14 @@ namespace network {
 static std::mutex       s_requestQueueMutex;
 static std::mutex       s_responseQueueMutex;
 
-static std::mutex       s_SleepMutex;
-static std::condition_variable      s_SleepCondition;
-
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 typedef int int32_t;
 #endif
 
 static bool s_need_quit = false;
+// whether a task of the ThreadPool is sending the queued requests, guarded by s_requestQueueMutex
+static bool s_sendingRequests = false;
 
 static Vector<HttpRequest*>*  s_requestQueue = nullptr;
 static Vector<HttpResponse*>* s_responseQueue = nullptr;
@@ -102,7 +101,7 @@ static int processDeleteTask(HttpRequest *request, write_callback callback, void
 // int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
 static void processResponse(HttpResponse* response, char* errorBuffer);
 
-// Worker thread
+// Runs on the ThreadPool, sends the queued requests one after the other
 void HttpClient::networkThread()
 {    
     HttpRequest *request = nullptr;
@@ -111,16 +110,17 @@ void HttpClient::networkThread()
     
     while (true) 
     {
-        if (s_need_quit)
-        {
-            break;
-        }
-        
         // step 1: send http request if the requestQueue isn't empty
         request = nullptr;
         
         s_requestQueueMutex.lock();
         
+        if (s_need_quit)
+        {
+            // clean up un-completed request queue
+            s_requestQueue->clear();
+        }
+        
         //Get request task from queue
         
         if (!s_requestQueue->empty())
@@ -128,15 +128,17 @@ void HttpClient::networkThread()
             request = s_requestQueue->at(0);
             s_requestQueue->erase(0);
         }
+        else
+        {
+            // the next send() starts a new task
+            s_sendingRequests = false;
+        }
         
         s_requestQueueMutex.unlock();
         
         if (nullptr == request)
         {
-            // Wait for http request tasks from main thread
-            std::unique_lock<std::mutex> lk(s_SleepMutex); 
-            s_SleepCondition.wait(lk);
-            continue;
+            break;
         }
         
         // step 2: libcurl sync access
@@ -156,48 +158,6 @@ void HttpClient::networkThread()
             scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
         }
     }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    s_requestQueueMutex.lock();
-    s_requestQueue->clear();
-    s_requestQueueMutex.unlock();
-    
-    
-    if (s_requestQueue != nullptr) {
-        delete s_requestQueue;
-        s_requestQueue = nullptr;
-        delete s_responseQueue;
-        s_responseQueue = nullptr;
-    }
-    
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest* request)
-{
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new HttpResponse(request);
-    char errorBuffer[CURL_ERROR_SIZE] = { 0 };
-    processResponse(response, errorBuffer);
-
-    auto scheduler = Director::getInstance()->getScheduler();
-    scheduler->performFunctionInCocosThread([response, request]{
-        const ccHttpRequestCallback& callback = request->getCallback();
-        Ref* pTarget = request->getTarget();
-        SEL_HttpResponse pSelector = request->getSelector();
-
-        if (callback != nullptr)
-        {
-            callback(s_pHttpClient, response);
-        }
-        else if (pTarget && pSelector)
-        {
-            (pTarget->*pSelector)(s_pHttpClient, response);
-        }
-        response->release();
-        // do not release in other thread
-        request->release();
-    });
 }
 
 //Configure curl's timeout property
@@ -462,16 +422,14 @@ HttpClient::HttpClient()
 
 HttpClient::~HttpClient()
 {
+    s_requestQueueMutex.lock();
     s_need_quit = true;
-    
-    if (s_requestQueue != nullptr) {
-        s_SleepCondition.notify_one();
-    }
+    s_requestQueueMutex.unlock();
     
     s_pHttpClient = nullptr;
 }
 
-//Lazy create semaphore & mutex & thread
+//Lazy create the queues
 bool HttpClient::lazyInitThreadSemphore()
 {
     if (s_requestQueue != nullptr) {
@@ -480,11 +438,6 @@ bool HttpClient::lazyInitThreadSemphore()
         
         s_requestQueue = new Vector<HttpRequest*>();
         s_responseQueue = new Vector<HttpResponse*>();
-        
-		s_need_quit = false;
-		
-        auto t = std::thread(CC_CALLBACK_0(HttpClient::networkThread, this));
-        t.detach();
     }
     
     return true;
@@ -507,11 +460,17 @@ void HttpClient::send(HttpRequest* request)
     
     if (nullptr != s_requestQueue) {
         s_requestQueueMutex.lock();
+        s_need_quit = false;
         s_requestQueue->pushBack(request);
+        bool startSending = !s_sendingRequests;
+        s_sendingRequests = true;
         s_requestQueueMutex.unlock();
         
-        // Notify thread start to work
-        s_SleepCondition.notify_one();
+        // one task at a time, so the requests are sent in order
+        if (startSending)
+        {
+            ThreadPool::getInstance()->submit(CC_CALLBACK_0(HttpClient::networkThread, this));
+        }
     }
 }
 
@@ -523,8 +482,30 @@ void HttpClient::sendImmediate(HttpRequest* request)
     }
 
     request->retain();
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request);
-    t.detach();
+
+    // Create a HttpResponse object, the default setting is http access failed
+    HttpResponse *response = new HttpResponse(request);
+
+    ThreadPool::getInstance()->submit([response](){
+        char errorBuffer[CURL_ERROR_SIZE] = { 0 };
+        processResponse(response, errorBuffer);
+    }, ThreadPool::Priority::HIGH).then([response, request](){
+        const ccHttpRequestCallback& callback = request->getCallback();
+        Ref* pTarget = request->getTarget();
+        SEL_HttpResponse pSelector = request->getSelector();
+
+        if (callback != nullptr)
+        {
+            callback(s_pHttpClient, response);
+        }
+        else if (pTarget && pSelector)
+        {
+            (pTarget->*pSelector)(s_pHttpClient, response);
+        }
+        response->release();
+        // do not release in other thread
+        request->release();
+    });
 }
 
 // Poll and notify main thread if responses exists in queue
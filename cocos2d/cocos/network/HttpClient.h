@@ -103,12 +103,11 @@ private:
     bool init(void);
     
     /**
-     * Init pthread mutex, semaphore, and create new thread for http requests
+     * Create the request and response queues, the requests are sent from the ThreadPool
      * @return bool
      */
     bool lazyInitThreadSemphore();
     void networkThread();
-    void networkThreadAlone(HttpRequest* request);
     /** Poll function called from main thread to dispatch callbacks when http requests finished **/
     void dispatchResponseCallbacks();
     
@@ -0,0 +1,220 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCDebugDrawBatch.h"
+
+#include <cmath>
+
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCRenderer.h"
+#include "base/ccMacros.h"
+#include "base/CCDirector.h"
+#include "CCGL.h"
+
+NS_CC_BEGIN
+
+static inline void transformPoint(const Mat4& transform, const Vec2& point, Vec3* out)
+{
+    Vec4 v(point.x, point.y, 0, 1);
+    transform.transformVector(&v);
+    out->set(v.x, v.y, v.z);
+}
+
+DebugDrawBatch::DebugDrawBatch()
+: _enabled(true)
+, _program(nullptr)
+{
+}
+
+DebugDrawBatch::~DebugDrawBatch()
+{
+    CC_SAFE_RELEASE(_program);
+}
+
+void DebugDrawBatch::drawLine(const Mat4& transform, const Vec2& origin, const Vec2& destination, const Color4F& color)
+{
+    Vec2 vertices[2] = { origin, destination };
+    drawPoly(transform, vertices, 2, false, color);
+}
+
+void DebugDrawBatch::drawRect(const Mat4& transform, const Vec2& origin, const Vec2& destination, const Color4F& color)
+{
+    Vec2 vertices[4] = {
+        origin,
+        Vec2(destination.x, origin.y),
+        destination,
+        Vec2(origin.x, destination.y)
+    };
+    drawPoly(transform, vertices, 4, true, color);
+}
+
+void DebugDrawBatch::drawSolidRect(const Mat4& transform, const Vec2& origin, const Vec2& destination, const Color4F& color)
+{
+    Vec2 vertices[4] = {
+        origin,
+        Vec2(destination.x, origin.y),
+        destination,
+        Vec2(origin.x, destination.y)
+    };
+    drawSolidPoly(transform, vertices, 4, color);
+}
+
+void DebugDrawBatch::drawPoly(const Mat4& transform, const Vec2* vertices, unsigned int numOfVertices, bool closePolygon, const Color4F& color)
+{
+    if (!_enabled || numOfVertices < 2)
+        return;
+
+    Color4B c(color);
+    unsigned int numOfLines = closePolygon ? numOfVertices : numOfVertices - 1;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t first = _lines.size();
+    _lines.resize(first + numOfLines * 2);
+    Vertex* out = &_lines[first];
+    for (unsigned int i = 0; i < numOfLines; ++i)
+    {
+        transformPoint(transform, vertices[i], &out[0].position);
+        transformPoint(transform, vertices[(i + 1) % numOfVertices], &out[1].position);
+        out[0].color = out[1].color = c;
+        out += 2;
+    }
+}
+
+void DebugDrawBatch::drawSolidPoly(const Mat4& transform, const Vec2* vertices, unsigned int numOfVertices, const Color4F& color)
+{
+    if (!_enabled || numOfVertices < 3)
+        return;
+
+    Color4B c(color);
+    Vec3 center;
+    transformPoint(transform, vertices[0], &center);
+
+    // triangle fan, split into a triangle list so every shape goes into the same draw
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t first = _triangles.size();
+    _triangles.resize(first + (numOfVertices - 2) * 3);
+    Vertex* out = &_triangles[first];
+    for (unsigned int i = 1; i + 1 < numOfVertices; ++i)
+    {
+        out[0].position = center;
+        transformPoint(transform, vertices[i], &out[1].position);
+        transformPoint(transform, vertices[i + 1], &out[2].position);
+        out[0].color = out[1].color = out[2].color = c;
+        out += 3;
+    }
+}
+
+void DebugDrawBatch::drawCircle(const Mat4& transform, const Vec2& center, float radius, float angle, unsigned int segments, bool drawLineToCenter, const Color4F& color)
+{
+    if (!_enabled || segments == 0)
+        return;
+
+    const float coef = 2.0f * (float)M_PI / segments;
+    std::vector<Vec2> vertices(segments + 2);
+    for (unsigned int i = 0; i < segments; ++i)
+    {
+        float rads = i * coef;
+        vertices[i].x = radius * cosf(rads + angle) + center.x;
+        vertices[i].y = radius * sinf(rads + angle) + center.y;
+    }
+
+    if (drawLineToCenter)
+    {
+        // close the circle, then go to the center
+        vertices[segments] = vertices[0];
+        vertices[segments + 1] = center;
+        drawPoly(transform, vertices.data(), segments + 2, false, color);
+    }
+    else
+    {
+        drawPoly(transform, vertices.data(), segments, true, color);
+    }
+}
+
+void DebugDrawBatch::drawSolidCircle(const Mat4& transform, const Vec2& center, float radius, unsigned int segments, const Color4F& color)
+{
+    if (!_enabled || segments < 3)
+        return;
+
+    const float coef = 2.0f * (float)M_PI / segments;
+    std::vector<Vec2> vertices(segments);
+    for (unsigned int i = 0; i < segments; ++i)
+    {
+        float rads = i * coef;
+        vertices[i].x = radius * cosf(rads) + center.x;
+        vertices[i].y = radius * sinf(rads) + center.y;
+    }
+    drawSolidPoly(transform, vertices.data(), segments, color);
+}
+
+void DebugDrawBatch::flush()
+{
+    if (_lines.empty() && _triangles.empty())
+        return;
+
+    if (!_program)
+    {
+        _program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
+        _program->retain();
+    }
+
+    // the vertices are already in the modelview space of the scene
+    _program->use();
+    _program->setUniformsForBuiltins(Mat4::IDENTITY);
+
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_COLOR);
+    GL::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // filled shapes first, so outlines stay visible
+    drawVertices(_triangles, GL_TRIANGLES);
+    drawVertices(_lines, GL_LINES);
+
+    clear();
+}
+
+void DebugDrawBatch::clear()
+{
+    _triangles.clear();
+    _lines.clear();
+}
+
+void DebugDrawBatch::drawVertices(const std::vector<Vertex>& vertices, GLenum mode)
+{
+    if (vertices.empty())
+        return;
+
+    const GLvoid* base = &vertices[0];
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid*)((char*)base + offsetof(Vertex, position)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (GLvoid*)((char*)base + offsetof(Vertex, color)));
+    glDrawArrays(mode, 0, (GLsizei)vertices.size());
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, vertices.size());
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
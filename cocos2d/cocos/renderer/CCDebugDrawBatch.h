@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_DEBUG_DRAW_BATCH_H__
+#define __CC_DEBUG_DRAW_BATCH_H__
+
+#include <vector>
+#include <mutex>
+
+#include "base/ccTypes.h"
+#include "math/CCMath.h"
+
+NS_CC_BEGIN
+
+class GLProgram;
+
+/** @brief Collects debug lines, rects and circles during a frame and draws them with one draw call per primitive type.
+
+ Unlike DrawPrimitives, which binds a program and issues a draw for every shape, the shapes are transformed
+ on the CPU and appended to a vertex stream. The Renderer draws the stream on top of the scene at the end of the frame.
+ It can be used from any draw() method:
+
+     renderer->getDebugDrawBatch()->drawRect(transform, Vec2(0,0), Vec2(16,16), Color4F::RED);
+
+ The shapes are always drawn on the screen: those added between RenderTexture::begin() and end() are not drawn into the texture.
+
+ @since v3.3
+ */
+class CC_DLL DebugDrawBatch
+{
+public:
+    DebugDrawBatch();
+    ~DebugDrawBatch();
+
+    /** Shapes added while it is disabled are dropped. Enabled by default */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /** draws a line. The points are transformed by transform */
+    void drawLine(const Mat4& transform, const Vec2& origin, const Vec2& destination, const Color4F& color);
+    /** draws the outline of a rectangle given its origin and destination points */
+    void drawRect(const Mat4& transform, const Vec2& origin, const Vec2& destination, const Color4F& color);
+    /** draws a filled rectangle given its origin and destination points */
+    void drawSolidRect(const Mat4& transform, const Vec2& origin, const Vec2& destination, const Color4F& color);
+    /** draws the outline of a polygon */
+    void drawPoly(const Mat4& transform, const Vec2* vertices, unsigned int numOfVertices, bool closePolygon, const Color4F& color);
+    /** draws a filled convex polygon */
+    void drawSolidPoly(const Mat4& transform, const Vec2* vertices, unsigned int numOfVertices, const Color4F& color);
+    /** draws the outline of a circle */
+    void drawCircle(const Mat4& transform, const Vec2& center, float radius, float angle, unsigned int segments, bool drawLineToCenter, const Color4F& color);
+    /** draws a filled circle */
+    void drawSolidCircle(const Mat4& transform, const Vec2& center, float radius, unsigned int segments, const Color4F& color);
+
+    /** draws the collected shapes and clears them. Called by the Renderer at the end of the frame */
+    void flush();
+
+    /** drops the collected shapes. Called by the Renderer at the end of every frame, even when nothing is drawn */
+    void clear();
+
+    /** number of vertices collected since the last flush */
+    ssize_t getLineVertexCount() const { return _lines.size(); }
+    ssize_t getTriangleVertexCount() const { return _triangles.size(); }
+
+protected:
+    struct Vertex
+    {
+        Vec3 position;
+        Color4B color;
+    };
+
+    void drawVertices(const std::vector<Vertex>& vertices, GLenum mode);
+
+    bool _enabled;
+    std::vector<Vertex> _lines;
+    std::vector<Vertex> _triangles;
+    // shapes can be added by the parallel visit threads
+    std::mutex _mutex;
+    GLProgram* _program;
+};
+
+NS_CC_END
+
+#endif //__CC_DEBUG_DRAW_BATCH_H__
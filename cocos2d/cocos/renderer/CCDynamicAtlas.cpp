@@ -0,0 +1,361 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCDynamicAtlas.h"
+
+#include <string.h>
+
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "platform/CCImage.h"
+#include "base/ccUtils.h"
+
+NS_CC_BEGIN
+
+DynamicAtlas::DynamicAtlas()
+{
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    removeAllPages();
+}
+
+Texture2D* DynamicAtlas::getTextureForKey(const std::string& key, Rect* rect) const
+{
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+        return nullptr;
+
+    *rect = it->second.rect;
+    return it->second.texture;
+}
+
+Texture2D* DynamicAtlas::addImage(Image* image, const std::string& key, Rect* rect)
+{
+    CCASSERT(image != nullptr, "DynamicAtlas: image MUST not be nil");
+
+    auto texture = getTextureForKey(key, rect);
+    if (texture)
+        return texture;
+
+    // Pages are premultiplied RGBA8888. RGB888 is opaque, so it is premultiplied by definition.
+    auto format = image->getRenderFormat();
+    if (image->isCompressed() ||
+        (format != Texture2D::PixelFormat::RGBA8888 && format != Texture2D::PixelFormat::RGB888) ||
+        (format == Texture2D::PixelFormat::RGBA8888 && !image->isPremultipliedAlpha()) ||
+        // a standalone texture would be converted to another default format
+        (Texture2D::getDefaultAlphaPixelFormat() != Texture2D::PixelFormat::AUTO &&
+         Texture2D::getDefaultAlphaPixelFormat() != Texture2D::PixelFormat::RGBA8888))
+    {
+        return nullptr;
+    }
+
+    int width = image->getWidth() + PADDING * 2;
+    int height = image->getHeight() + PADDING * 2;
+    if (image->getWidth() > MAX_IMAGE_SIZE || image->getHeight() > MAX_IMAGE_SIZE)
+    {
+        return nullptr;
+    }
+
+    int x = 0, y = 0;
+    size_t index = 0;
+    Page* page = nullptr;
+    for (auto& candidate : _pages)
+    {
+        if (findPosition(candidate, width, height, &x, &y, &index))
+        {
+            page = &candidate;
+            break;
+        }
+    }
+
+    if (page == nullptr)
+    {
+        if (!createPage())
+            return nullptr;
+
+        page = &_pages.back();
+        bool found = findPosition(*page, width, height, &x, &y, &index);
+        CC_UNUSED_PARAM(found);
+        CCASSERT(found, "DynamicAtlas: an empty page should fit any image up to MAX_IMAGE_SIZE");
+    }
+
+    addSkylineLevel(*page, index, x, y, width, height);
+    uploadImage(*page, image, x, y);
+
+    Entry entry;
+    entry.texture = page->texture;
+    entry.rect = Rect(x + PADDING, y + PADDING, image->getWidth(), image->getHeight());
+    _entries.insert(std::make_pair(key, entry));
+
+    *rect = entry.rect;
+    return entry.texture;
+}
+
+bool DynamicAtlas::createPage()
+{
+    auto data = static_cast<unsigned char*>(calloc(PAGE_SIZE * PAGE_SIZE * 4, sizeof(unsigned char)));
+    if (data == nullptr)
+        return false;
+
+    Image* image = new (std::nothrow) Image();
+    bool ret = image && image->initWithRawData(data, PAGE_SIZE * PAGE_SIZE * 4, PAGE_SIZE, PAGE_SIZE, 8, true);
+    free(data);
+
+    Texture2D* texture = nullptr;
+    if (ret)
+    {
+        texture = new (std::nothrow) Texture2D();
+        ret = texture && texture->initWithImage(image, Texture2D::PixelFormat::RGBA8888);
+    }
+
+    if (!ret)
+    {
+        CCLOG("cocos2d: DynamicAtlas: couldn't create a %dx%d page", PAGE_SIZE, PAGE_SIZE);
+        CC_SAFE_RELEASE(texture);
+        CC_SAFE_RELEASE(image);
+        return false;
+    }
+
+    Page page;
+    page.texture = texture;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the texture is restored from the image, which uploadImage() keeps up to date
+    VolatileTextureMgr::addImage(texture, image);
+    page.image = image;
+#else
+    page.image = nullptr;
+    image->release();
+#endif
+    page.usedArea = 0;
+
+    SkylineNode node;
+    node.x = 0;
+    node.y = 0;
+    node.width = PAGE_SIZE;
+    page.skyline.push_back(node);
+
+    _pages.push_back(page);
+    return true;
+}
+
+bool DynamicAtlas::fitSkyline(const Page& page, size_t index, int width, int height, int* y) const
+{
+    int x = page.skyline[index].x;
+    if (x + width > PAGE_SIZE)
+        return false;
+
+    int widthLeft = width;
+    int top = page.skyline[index].y;
+    while (widthLeft > 0)
+    {
+        top = std::max(top, page.skyline[index].y);
+        if (top + height > PAGE_SIZE)
+            return false;
+
+        widthLeft -= page.skyline[index].width;
+        ++index;
+    }
+
+    *y = top;
+    return true;
+}
+
+bool DynamicAtlas::findPosition(const Page& page, int width, int height, int* x, int* y, size_t* index) const
+{
+    // bottom-left rule: lowest top edge wins, then the narrowest level
+    int bestTop = PAGE_SIZE + 1;
+    int bestWidth = PAGE_SIZE + 1;
+    bool found = false;
+
+    for (size_t i = 0; i < page.skyline.size(); ++i)
+    {
+        int top = 0;
+        if (fitSkyline(page, i, width, height, &top))
+        {
+            const SkylineNode& node = page.skyline[i];
+            if (top + height < bestTop || (top + height == bestTop && node.width < bestWidth))
+            {
+                bestTop = top + height;
+                bestWidth = node.width;
+                *x = node.x;
+                *y = top;
+                *index = i;
+                found = true;
+            }
+        }
+    }
+
+    return found;
+}
+
+void DynamicAtlas::addSkylineLevel(Page& page, size_t index, int x, int y, int width, int height)
+{
+    SkylineNode node;
+    node.x = x;
+    node.y = y + height;
+    node.width = width;
+    page.skyline.insert(page.skyline.begin() + index, node);
+
+    // shrink or remove the levels now covered by the new one
+    for (size_t i = index + 1; i < page.skyline.size(); ++i)
+    {
+        const SkylineNode& previous = page.skyline[i - 1];
+        SkylineNode& current = page.skyline[i];
+        if (current.x >= previous.x + previous.width)
+            break;
+
+        int shrink = previous.x + previous.width - current.x;
+        current.x += shrink;
+        current.width -= shrink;
+        if (current.width > 0)
+            break;
+
+        page.skyline.erase(page.skyline.begin() + i);
+        --i;
+    }
+
+    // merge neighbouring levels with the same height
+    for (size_t i = 0; i + 1 < page.skyline.size(); )
+    {
+        if (page.skyline[i].y == page.skyline[i + 1].y)
+        {
+            page.skyline[i].width += page.skyline[i + 1].width;
+            page.skyline.erase(page.skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    page.usedArea += width * height;
+}
+
+void DynamicAtlas::uploadImage(Page& page, Image* image, int x, int y)
+{
+    const int imageWidth = image->getWidth();
+    const int imageHeight = image->getHeight();
+    const int width = imageWidth + PADDING * 2;
+    const int height = imageHeight + PADDING * 2;
+    const int srcBytesPerPixel = image->getRenderFormat() == Texture2D::PixelFormat::RGB888 ? 3 : 4;
+    const unsigned char* src = image->getData();
+
+    auto data = static_cast<unsigned char*>(malloc(width * height * 4));
+    if (data == nullptr)
+        return;
+
+    // copy the image and extrude its edge pixels into the border
+    for (int row = 0; row < height; ++row)
+    {
+        int srcRow = std::min(std::max(row - PADDING, 0), imageHeight - 1);
+        for (int col = 0; col < width; ++col)
+        {
+            int srcCol = std::min(std::max(col - PADDING, 0), imageWidth - 1);
+            const unsigned char* in = src + (srcRow * imageWidth + srcCol) * srcBytesPerPixel;
+            unsigned char* out = data + (row * width + col) * 4;
+            out[0] = in[0];
+            out[1] = in[1];
+            out[2] = in[2];
+            out[3] = srcBytesPerPixel == 4 ? in[3] : 255;
+        }
+    }
+
+    page.texture->updateWithData(data, x, y, width, height);
+
+    if (page.image)
+    {
+        unsigned char* pagePixels = page.image->getData();
+        for (int row = 0; row < height; ++row)
+        {
+            memcpy(pagePixels + ((y + row) * PAGE_SIZE + x) * 4, data + row * width * 4, width * 4);
+        }
+    }
+
+    free(data);
+}
+
+void DynamicAtlas::removeUnusedPages()
+{
+    for (auto it = _pages.begin(); it != _pages.end(); /* nothing */)
+    {
+        Texture2D* texture = it->texture;
+        if (texture->getReferenceCount() == 1)
+        {
+            CCLOG("cocos2d: DynamicAtlas: removing unused page: %u", texture->getName());
+
+            for (auto entry = _entries.begin(); entry != _entries.end(); /* nothing */)
+            {
+                if (entry->second.texture == texture)
+                    entry = _entries.erase(entry);
+                else
+                    ++entry;
+            }
+
+            CC_SAFE_RELEASE(it->image);
+            texture->release();
+            it = _pages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void DynamicAtlas::removeAllPages()
+{
+    for (auto& page : _pages)
+    {
+        CC_SAFE_RELEASE(page.image);
+        page.texture->release();
+    }
+    _pages.clear();
+    _entries.clear();
+}
+
+std::string DynamicAtlas::getInfo() const
+{
+    std::string buffer;
+    char buftmp[256];
+
+    for (const auto& page : _pages)
+    {
+        snprintf(buftmp, sizeof(buftmp)-1, "DynamicAtlas page id=%lu rc=%lu %d x %d => %.1f%% used\n",
+               (long)page.texture->getName(),
+               (long)page.texture->getReferenceCount(),
+               PAGE_SIZE,
+               PAGE_SIZE,
+               page.usedArea * 100.0f / (PAGE_SIZE * PAGE_SIZE));
+        buffer += buftmp;
+    }
+
+    snprintf(buftmp, sizeof(buftmp)-1, "DynamicAtlas: %ld images in %ld pages\n", (long)_entries.size(), (long)_pages.size());
+    buffer += buftmp;
+
+    return buffer;
+}
+
+NS_CC_END
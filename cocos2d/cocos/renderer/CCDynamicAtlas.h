@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_DYNAMIC_ATLAS_H__
+#define __CC_DYNAMIC_ATLAS_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/ccMacros.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+class Image;
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief DynamicAtlas packs small images into shared RGBA8888 pages at runtime.
+
+ Sprites whose images end up in the same page share a texture, so their `QuadCommand`s
+ get the same material ID and the renderer batches them without an offline TexturePacker step.
+ Images are placed with a skyline bottom-left packer and surrounded by an extruded border
+ so that linear filtering doesn't bleed neighbours into each other.
+
+ It is owned by the TextureCache. Use TextureCache::setDynamicAtlasEnabled() and
+ TextureCache::addImageToDynamicAtlas() instead of using it directly.
+ @since v3.3
+ */
+class CC_DLL DynamicAtlas
+{
+public:
+    /** width and height of each page, in pixels */
+    static const int PAGE_SIZE = 1024;
+    /** images wider or higher than this (in pixels) are never atlased */
+    static const int MAX_IMAGE_SIZE = 256;
+    /** extruded border added around each image, in pixels */
+    static const int PADDING = 2;
+
+    DynamicAtlas();
+    ~DynamicAtlas();
+
+    /** Returns the page holding the image registered with `key` and sets `rect` (in pixels), or nullptr if there is none */
+    Texture2D* getTextureForKey(const std::string& key, Rect* rect) const;
+
+    /** Copies the image into a page and registers it with `key`.
+     Returns the page and sets `rect` (in pixels) on success.
+     Returns nullptr if the image is compressed, too big, or uses an unsupported pixel format,
+     or if the default alpha pixel format of Texture2D is neither AUTO nor RGBA8888.
+     */
+    Texture2D* addImage(Image* image, const std::string& key, Rect* rect);
+
+    /** Releases every page that is not used by anybody but the atlas */
+    void removeUnusedPages();
+
+    /** Releases all the pages. Sprites using them keep them alive until they are released */
+    void removeAllPages();
+
+    /** Returns the number of pages */
+    ssize_t getPageCount() const { return _pages.size(); }
+
+    /** Returns the number of images packed into the pages */
+    ssize_t getImageCount() const { return _entries.size(); }
+
+    /** Returns a debug string with the occupancy of each page */
+    std::string getInfo() const;
+
+protected:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+        // Keeps the page pixels so VolatileTextureMgr can restore them after the GL context is lost
+        Image* image;
+        std::vector<SkylineNode> skyline;
+        int usedArea;
+    };
+
+    struct Entry
+    {
+        Texture2D* texture;
+        Rect rect;
+    };
+
+    bool createPage();
+    bool fitSkyline(const Page& page, size_t index, int width, int height, int* y) const;
+    bool findPosition(const Page& page, int width, int height, int* x, int* y, size_t* index) const;
+    void addSkylineLevel(Page& page, size_t index, int x, int y, int width, int height);
+    void uploadImage(Page& page, Image* image, int x, int y);
+
+    std::vector<Page> _pages;
+    std::unordered_map<std::string, Entry> _entries;
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CC_DYNAMIC_ATLAS_H__
@@ -34,9 +34,11 @@ THE SOFTWARE.
 
 #include "base/CCDirector.h"
 #include "base/ccMacros.h"
+#include "base/CCConfiguration.h"
 #include "base/uthash.h"
 #include "renderer/ccGLStateCache.h"
 #include "platform/CCFileUtils.h"
+#include "base/CCData.h"
 #include "CCGL.h"
 
 #include "deprecated/CCString.h"
@@ -126,6 +128,9 @@ GLProgram* GLProgram::createWithFilenames(const std::string& vShaderFilename, co
     return nullptr;
 }
 
+unsigned int GLProgram::s_uniformCallsIssued = 0;
+unsigned int GLProgram::s_uniformCallsSkipped = 0;
+
 GLProgram::GLProgram()
 : _program(0)
 , _vertShader(0)
@@ -157,15 +162,7 @@ GLProgram::~GLProgram()
         GL::deleteProgram(_program);
     }
 
-    tHashUniformEntry *current_element, *tmp;
-
-    // Purge uniform hash
-    HASH_ITER(hh, _hashForUniforms, current_element, tmp)
-    {
-        HASH_DEL(_hashForUniforms, current_element);
-        free(current_element->value);
-        free(current_element);
-    }
+    purgeUniformCache();
 }
 
 bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
@@ -532,6 +529,14 @@ bool GLProgram::link()
 
     bindPredefinedVertexAttribs();
 
+#if CC_ENABLE_PROGRAM_BINARY_CACHE && defined(GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+    // with ARB_get_program_binary the binary can only be retrieved if it was requested before linking
+    if (Configuration::getInstance()->supportsProgramBinary())
+    {
+        glProgramParameteri(_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+
     glLinkProgram(_program);
 
     parseVertexAttribs();
@@ -570,6 +575,69 @@ bool GLProgram::link()
     return (status == GL_TRUE);
 }
 
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+bool GLProgram::initWithProgramBinary(const Data& binary)
+{
+    // the binary starts with its format
+    if (binary.getSize() <= (ssize_t)sizeof(GLenum))
+    {
+        return false;
+    }
+
+    GLenum format = 0;
+    memcpy(&format, binary.getBytes(), sizeof(format));
+
+    _program = glCreateProgram();
+    _vertShader = _fragShader = 0;
+    _hashForUniforms = nullptr;
+    glProgramBinary(_program, format, binary.getBytes() + sizeof(format), (GLsizei)(binary.getSize() - sizeof(format)));
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(_program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE)
+    {
+        GL::deleteProgram(_program);
+        _program = 0;
+        // clear the error raised by a rejected binary
+        glGetError();
+        return false;
+    }
+
+    parseVertexAttribs();
+    parseUniforms();
+
+    CHECK_GL_ERROR_DEBUG();
+    return true;
+}
+
+Data GLProgram::getProgramBinary() const
+{
+    Data ret;
+
+    GLint length = 0;
+    glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return ret;
+    }
+
+    ssize_t size = sizeof(GLenum) + length;
+    unsigned char* bytes = (unsigned char*)malloc(size);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(_program, length, &written, &format, bytes + sizeof(GLenum));
+    if (written <= 0)
+    {
+        free(bytes);
+        return ret;
+    }
+
+    memcpy(bytes, &format, sizeof(format));
+    ret.fastSet(bytes, sizeof(GLenum) + written);
+    return ret;
+}
+#endif
+
 void GLProgram::use()
 {
     GL::useProgram(_program);
@@ -610,6 +678,22 @@ std::string GLProgram::getProgramLog() const
 
 // Uniform cache
 
+void GLProgram::purgeUniformCache()
+{
+    tHashUniformEntry *current_element, *tmp;
+
+    // Purge uniform hash
+    HASH_ITER(hh, _hashForUniforms, current_element, tmp)
+    {
+        HASH_DEL(_hashForUniforms, current_element);
+        free(current_element->value);
+        free(current_element);
+    }
+    _hashForUniforms = nullptr;
+
+    _uniformCache.clear();
+}
+
 bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsigned int bytes)
 {
     if (location < 0)
@@ -617,6 +701,29 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         return false;
     }
 
+    // fast path: most programs have a few uniforms with small locations
+    if (location < MAX_FLAT_CACHED_UNIFORM_LOCATION && bytes <= sizeof(UniformCacheEntry::value))
+    {
+        if (location >= (GLint)_uniformCache.size())
+        {
+            UniformCacheEntry empty;
+            empty.bytes = 0;
+            _uniformCache.resize(location + 1, empty);
+        }
+
+        auto& entry = _uniformCache[location];
+        if (entry.bytes == bytes && memcmp(entry.value, data, bytes) == 0)
+        {
+            ++s_uniformCallsSkipped;
+            return false;
+        }
+
+        entry.bytes = bytes;
+        memcpy(entry.value, data, bytes);
+        ++s_uniformCallsIssued;
+        return true;
+    }
+
     bool updated = true;
     tHashUniformEntry *element = nullptr;
     HASH_FIND_INT(_hashForUniforms, &location, element);
@@ -646,6 +753,11 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         }
     }
 
+    if (updated)
+        ++s_uniformCallsIssued;
+    else
+        ++s_uniformCallsSkipped;
+
     return updated;
 }
 
@@ -885,16 +997,7 @@ void GLProgram::reset()
     _program = 0;
 
     
-    tHashUniformEntry *current_element, *tmp;
-    
-    // Purge uniform hash
-    HASH_ITER(hh, _hashForUniforms, current_element, tmp) 
-    {
-        HASH_DEL(_hashForUniforms, current_element);
-        free(current_element->value);
-        free(current_element);
-    }
-    _hashForUniforms = nullptr;
+    purgeUniformCache();
 }
 
 NS_CC_END
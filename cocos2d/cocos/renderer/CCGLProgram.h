@@ -31,6 +31,7 @@ THE SOFTWARE.
 #define __CCGLPROGRAM_H__
 
 #include <unordered_map>
+#include <vector>
 
 #include "base/ccMacros.h"
 #include "base/CCRef.h"
@@ -47,6 +48,7 @@ NS_CC_BEGIN
 
 struct _hashUniformEntry;
 class GLProgram;
+class Data;
 
 typedef void (*GLInfoFunction)(GLuint program, GLenum pname, GLint* params);
 typedef void (*GLLogFunction) (GLuint program, GLsizei bufsize, GLsizei* length, GLchar* infolog);
@@ -183,6 +185,19 @@ public:
     static GLProgram* createWithFilenames(const std::string& vShaderFilename, const std::string& fShaderFilename);
     bool initWithFilenames(const std::string& vShaderFilename, const std::string& fShaderFilename);
 
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    /** Initializes the GLProgram with a binary returned by getProgramBinary(). The program is already linked: don't call link().
+     Returns false if the driver rejects the binary, for instance after a driver update.
+     Only valid if Configuration::supportsProgramBinary() returns true.
+     @since v3.3
+     */
+    bool initWithProgramBinary(const Data& binary);
+    /** Returns the binary of the linked program, or an empty Data if the driver doesn't provide it
+     @since v3.3
+     */
+    Data getProgramBinary() const;
+#endif
+
 	//void bindUniform(std::string uniformName, int value);
 	Uniform* getUniform(const std::string& name);
     VertexAttrib* getVertexAttrib(const std::string& name);
@@ -302,6 +317,12 @@ public:
     
     inline const GLuint getProgram() const { return _program; }
 
+    /** Returns the number of glUniform calls issued by all the programs since resetUniformCallCounters() */
+    static unsigned int getUniformCallsIssued() { return s_uniformCallsIssued; }
+    /** Returns the number of glUniform calls skipped by all the programs because the value didn't change, since resetUniformCallCounters() */
+    static unsigned int getUniformCallsSkipped() { return s_uniformCallsSkipped; }
+    static void resetUniformCallCounters() { s_uniformCallsIssued = s_uniformCallsSkipped = 0; }
+
     // DEPRECATED
     CC_DEPRECATED_ATTRIBUTE bool initWithVertexShaderByteArray(const GLchar* vertexByteArray, const GLchar* fragByteArray)
     { return initWithByteArrays(vertexByteArray, fragByteArray); }
@@ -311,7 +332,17 @@ public:
 
 
 protected:
+    /** Uniform values with a location lower than this, and up to a Mat4 in size, are cached in a flat array */
+    static const GLint MAX_FLAT_CACHED_UNIFORM_LOCATION = 64;
+
+    struct UniformCacheEntry
+    {
+        unsigned int bytes;
+        GLfloat value[16];
+    };
+
     bool updateUniformLocation(GLint location, const GLvoid* data, unsigned int bytes);
+    void purgeUniformCache();
     virtual std::string getDescription() const;
 
     void bindPredefinedVertexAttribs();
@@ -326,12 +357,16 @@ protected:
     GLuint            _fragShader;
     GLint             _builtInUniforms[UNIFORM_MAX];
     struct _hashUniformEntry* _hashForUniforms;
+    std::vector<UniformCacheEntry> _uniformCache;
 	bool              _hasShaderCompiler;
         
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
     std::string       _shaderId;
 #endif
 
+    static unsigned int s_uniformCallsIssued;
+    static unsigned int s_uniformCallsSkipped;
+
     struct flag_struct {
         unsigned int usesTime:1;
         unsigned int usesMVP:1;
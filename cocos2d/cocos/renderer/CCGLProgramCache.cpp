@@ -30,6 +30,10 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccShaders.h"
 #include "base/ccMacros.h"
+#include "base/CCConfiguration.h"
+#include "base/CCData.h"
+#include "platform/CCFileUtils.h"
+#include "xxhash.h"
 
 NS_CC_BEGIN
 
@@ -109,279 +113,222 @@ bool GLProgramCache::init()
 
 void GLProgramCache::loadDefaultGLPrograms()
 {
-    // Position Texture Color shader
-    GLProgram *p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, p ) );
-
-    // Position Texture Color without MVP shader
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p ) );
-
-    // Position Texture Color alpha test
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST, p) );
-
-    // Position Texture Color alpha test
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, p) );
-    //
-    // Position, Color shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR, p) );
-
-    //
-    // Position, Color shader no MVP
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP, p) );
-
-    //
-    // Position Texture shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE, p) );
-
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    _programs.insert( std::make_pair( GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR, p) );
-
-    //
-    // Position Texture A8 Color shader
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR, p) );
-
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_U_COLOR, p) );
-    
-    //
-	// Position, Legth(TexCoords, Color (used by Draw Node basically )
-	//
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_OUTLINE, p) );
-    
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION, p) );
-
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_TEXTURE, p) );
-    
-    p = new GLProgram();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
-    _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p));
+    // The default programs are compiled the first time they are requested, see getGLProgram()
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR] = kShaderType_PositionTextureColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP] = kShaderType_PositionTextureColor_noMVP;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST] = kShaderType_PositionTextureColorAlphaTest;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV] = kShaderType_PositionTextureColorAlphaTestNoMV;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_COLOR] = kShaderType_PositionColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP] = kShaderType_PositionColor_noMVP;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE] = kShaderType_PositionTexture;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR] = kShaderType_PositionTexture_uColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR] = kShaderType_PositionTextureA8Color;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_U_COLOR] = kShaderType_Position_uColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR] = kShaderType_PositionLengthTexureColor;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL] = kShaderType_LabelDistanceFieldNormal;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW] = kShaderType_LabelDistanceFieldGlow;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_NORMAL] = kShaderType_LabelNormal;
+    _defaultPrograms[GLProgram::SHADER_NAME_LABEL_OUTLINE] = kShaderType_LabelOutline;
+    _defaultPrograms[GLProgram::SHADER_3D_POSITION] = kShaderType_3DPosition;
+    _defaultPrograms[GLProgram::SHADER_3D_POSITION_TEXTURE] = kShaderType_3DPositionTex;
+    _defaultPrograms[GLProgram::SHADER_3D_SKINPOSITION_TEXTURE] = kShaderType_3DSkinPositionTex;
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
 {
-    // reset all programs and reload them
-    
-    // Position Texture Color shader
-    GLProgram *p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);    
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor);
-
-    // Position Texture Color without MVP shader
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
-
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
-    
-    // Position Texture Color alpha test
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
-    p->reset();    
-    loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
-    //
-    // Position, Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionColor);
-    
-    //
-    // Position, Color shader no MVP
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP);
-    loadDefaultGLProgram(p, kShaderType_PositionColor_noMVP);
-
-    //
-    // Position Texture shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture);
-    
-    //
-    // Position, Texture attribs, 1 Color as uniform shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTexture_uColor);
-    
-    //
-    // Position Texture A8 Color shader
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionTextureA8Color);
-    
-    //
-    // Position and 1 color passed as a uniform (to simulate glColor4ub )
-    //
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_U_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_Position_uColor);
-    
-    //
-	// Position, Legth(TexCoords, Color (used by Draw Node basically )
-	//
-    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_PositionLengthTexureColor);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldGlow);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelNormal);
-
-    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_LabelOutline);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPosition);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DPositionTex);
-    
-    p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE);
-    p->reset();
-    loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
+    // reset the default programs that were already compiled and reload them
+    for (const auto& it : _defaultPrograms)
+    {
+        auto found = _programs.find(it.first);
+        if (found == _programs.end())
+            continue;
+
+        GLProgram *p = found->second;
+        p->reset();
+        loadDefaultGLProgram(p, it.second);
+    }
 }
 
-void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
+bool GLProgramCache::getDefaultGLProgramSources(int type, const char** vShaderByteArray, const char** fShaderByteArray)
 {
     switch (type) {
         case kShaderType_PositionTextureColor:
-            p->initWithByteArrays(ccPositionTextureColor_vert, ccPositionTextureColor_frag);
+            *vShaderByteArray = ccPositionTextureColor_vert; *fShaderByteArray = ccPositionTextureColor_frag;
             break;
         case kShaderType_PositionTextureColor_noMVP:
-            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColor_noMVP_frag);
+            *vShaderByteArray = ccPositionTextureColor_noMVP_vert; *fShaderByteArray = ccPositionTextureColor_noMVP_frag;
             break;
 
         case kShaderType_PositionTextureColorAlphaTest:
-            p->initWithByteArrays(ccPositionTextureColor_vert, ccPositionTextureColorAlphaTest_frag);
+            *vShaderByteArray = ccPositionTextureColor_vert; *fShaderByteArray = ccPositionTextureColorAlphaTest_frag;
             break;
         case kShaderType_PositionTextureColorAlphaTestNoMV:
-            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColorAlphaTest_frag);
+            *vShaderByteArray = ccPositionTextureColor_noMVP_vert; *fShaderByteArray = ccPositionTextureColorAlphaTest_frag;
             break;
 
         case kShaderType_PositionColor:  
-            p->initWithByteArrays(ccPositionColor_vert ,ccPositionColor_frag);
+            *vShaderByteArray = ccPositionColor_vert; *fShaderByteArray = ccPositionColor_frag;
             break;
         case kShaderType_PositionColor_noMVP:
-            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert ,ccPositionColor_frag);
+            *vShaderByteArray = ccPositionTextureColor_noMVP_vert; *fShaderByteArray = ccPositionColor_frag;
             break;
         case kShaderType_PositionTexture:
-            p->initWithByteArrays(ccPositionTexture_vert ,ccPositionTexture_frag);
+            *vShaderByteArray = ccPositionTexture_vert; *fShaderByteArray = ccPositionTexture_frag;
             break;
         case kShaderType_PositionTexture_uColor:
-            p->initWithByteArrays(ccPositionTexture_uColor_vert, ccPositionTexture_uColor_frag);
+            *vShaderByteArray = ccPositionTexture_uColor_vert; *fShaderByteArray = ccPositionTexture_uColor_frag;
             break;
         case kShaderType_PositionTextureA8Color:
-            p->initWithByteArrays(ccPositionTextureA8Color_vert, ccPositionTextureA8Color_frag);
+            *vShaderByteArray = ccPositionTextureA8Color_vert; *fShaderByteArray = ccPositionTextureA8Color_frag;
             break;
         case kShaderType_Position_uColor:
-            p->initWithByteArrays(ccPosition_uColor_vert, ccPosition_uColor_frag);
-            p->bindAttribLocation("aVertex", GLProgram::VERTEX_ATTRIB_POSITION);
+            *vShaderByteArray = ccPosition_uColor_vert; *fShaderByteArray = ccPosition_uColor_frag;
             break;
         case kShaderType_PositionLengthTexureColor:
-            p->initWithByteArrays(ccPositionColorLengthTexture_vert, ccPositionColorLengthTexture_frag);
+            *vShaderByteArray = ccPositionColorLengthTexture_vert; *fShaderByteArray = ccPositionColorLengthTexture_frag;
             break;
         case kShaderType_LabelDistanceFieldNormal:
-            p->initWithByteArrays(ccLabel_vert, ccLabelDistanceFieldNormal_frag);
+            *vShaderByteArray = ccLabel_vert; *fShaderByteArray = ccLabelDistanceFieldNormal_frag;
             break;
         case kShaderType_LabelDistanceFieldGlow:
-            p->initWithByteArrays(ccLabel_vert, ccLabelDistanceFieldGlow_frag);
+            *vShaderByteArray = ccLabel_vert; *fShaderByteArray = ccLabelDistanceFieldGlow_frag;
             break;
         case kShaderType_LabelNormal:
-            p->initWithByteArrays(ccLabel_vert, ccLabelNormal_frag);
+            *vShaderByteArray = ccLabel_vert; *fShaderByteArray = ccLabelNormal_frag;
             break;
         case kShaderType_LabelOutline:
-            p->initWithByteArrays(ccLabel_vert, ccLabelOutline_frag);
+            *vShaderByteArray = ccLabel_vert; *fShaderByteArray = ccLabelOutline_frag;
             break;
         case kShaderType_3DPosition:
-            p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_Color_frag);
+            *vShaderByteArray = cc3D_PositionTex_vert; *fShaderByteArray = cc3D_Color_frag;
             break;
         case kShaderType_3DPositionTex:
-            p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_ColorTex_frag);
+            *vShaderByteArray = cc3D_PositionTex_vert; *fShaderByteArray = cc3D_ColorTex_frag;
             break;
         case kShaderType_3DSkinPositionTex:
-            p->initWithByteArrays(cc3D_SkinPositionTex_vert, cc3D_ColorTex_frag);
+            *vShaderByteArray = cc3D_SkinPositionTex_vert; *fShaderByteArray = cc3D_ColorTex_frag;
             break;
         default:
             CCLOG("cocos2d: %s:%d, error shader type", __FUNCTION__, __LINE__);
-            return;
+            return false;
+    }
+    return true;
+}
+
+void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
+{
+    const GLchar* vShaderByteArray = nullptr;
+    const GLchar* fShaderByteArray = nullptr;
+    if (!getDefaultGLProgramSources(type, &vShaderByteArray, &fShaderByteArray))
+        return;
+
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    std::string binaryPath;
+    if (Configuration::getInstance()->supportsProgramBinary())
+    {
+        binaryPath = getProgramBinaryPath(vShaderByteArray, fShaderByteArray);
+        // not an error on the first run, don't let getDataFromFile() log it
+        if (FileUtils::getInstance()->isFileExist(binaryPath))
+        {
+            Data binary = FileUtils::getInstance()->getDataFromFile(binaryPath);
+            if (!binary.isNull() && p->initWithProgramBinary(binary))
+            {
+                p->updateUniforms();
+                CHECK_GL_ERROR_DEBUG();
+                return;
+            }
+        }
+    }
+#endif
+
+    p->initWithByteArrays(vShaderByteArray, fShaderByteArray);
+    if (type == kShaderType_Position_uColor)
+    {
+        p->bindAttribLocation("aVertex", GLProgram::VERTEX_ATTRIB_POSITION);
     }
     
     p->link();
     p->updateUniforms();
     
     CHECK_GL_ERROR_DEBUG();
+
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    if (!binaryPath.empty())
+    {
+        saveProgramBinary(p, binaryPath);
+    }
+#endif
+}
+
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+// defined in cocos2d.cpp
+CC_DLL const char* cocos2dVersion();
+
+std::string GLProgramCache::getProgramBinaryPath(const char* vShaderByteArray, const char* fShaderByteArray)
+{
+    // binaries are only valid for the driver that produced them
+    std::string key = vShaderByteArray;
+    key += '\0';
+    key += fShaderByteArray;
+    key += '\0';
+    key += (const char*)glGetString(GL_VENDOR);
+    key += (const char*)glGetString(GL_RENDERER);
+    key += (const char*)glGetString(GL_VERSION);
+    key += cocos2dVersion();
+
+    char name[64];
+    snprintf(name, sizeof(name), "ccprogram_%08x%08x.bin",
+             XXH32(key.data(), (int)key.size(), 0),
+             XXH32(key.data(), (int)key.size(), 0x9E3779B1));
+    return FileUtils::getInstance()->getWritablePath() + name;
+}
+
+void GLProgramCache::saveProgramBinary(GLProgram *p, const std::string& path)
+{
+    Data binary = p->getProgramBinary();
+    if (binary.isNull())
+        return;
+
+    // written aside then renamed, so that an interrupted write never leaves a truncated binary behind
+    std::string tempPath = path + ".tmp";
+    FILE* fp = fopen(tempPath.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("cocos2d: GLProgramCache: cannot write %s", tempPath.c_str());
+        return;
+    }
+    bool written = (fwrite(binary.getBytes(), 1, binary.getSize(), fp) == (size_t)binary.getSize());
+    written = (fclose(fp) == 0) && written;
+
+    if (written)
+    {
+        // rename() doesn't replace an existing file on Windows
+        remove(path.c_str());
+        written = (rename(tempPath.c_str(), path.c_str()) == 0);
+    }
+    if (!written)
+    {
+        CCLOG("cocos2d: GLProgramCache: cannot write %s", path.c_str());
+        remove(tempPath.c_str());
+    }
 }
+#endif
 
 GLProgram* GLProgramCache::getGLProgram(const std::string &key)
 {
     auto it = _programs.find(key);
     if( it != _programs.end() )
         return it->second;
+
+    // compile the default programs on demand
+    auto defaultIt = _defaultPrograms.find(key);
+    if( defaultIt != _defaultPrograms.end() )
+    {
+        GLProgram *p = new GLProgram();
+        loadDefaultGLProgram(p, defaultIt->second);
+        _programs.insert( std::make_pair(key, p) );
+        return p;
+    }
     return nullptr;
 }
 
@@ -75,11 +75,12 @@ public:
     void loadDefaultGLPrograms();
     CC_DEPRECATED_ATTRIBUTE void loadDefaultShaders() { loadDefaultGLPrograms(); }
 
-    /** reload the default shaders */
+    /** reload the default shaders that have already been compiled */
     void reloadDefaultGLPrograms();
     CC_DEPRECATED_ATTRIBUTE void reloadDefaultShaders() { reloadDefaultGLPrograms(); }
 
-    /** returns a GL program for a given key 
+    /** returns a GL program for a given key.
+     Default programs are compiled the first time they are requested.
      */
     GLProgram * getGLProgram(const std::string &key);
     CC_DEPRECATED_ATTRIBUTE GLProgram * getProgram(const std::string &key) { return getGLProgram(key); }
@@ -92,9 +93,16 @@ public:
 private:
     bool init();
     void loadDefaultGLProgram(GLProgram *program, int type);
+    bool getDefaultGLProgramSources(int type, const char** vShaderByteArray, const char** fShaderByteArray);
+#if CC_ENABLE_PROGRAM_BINARY_CACHE
+    std::string getProgramBinaryPath(const char* vShaderByteArray, const char* fShaderByteArray);
+    void saveProgramBinary(GLProgram *program, const std::string& path);
+#endif
 
 //    Dictionary* _programs;
     std::unordered_map<std::string, GLProgram*> _programs;
+    // names of the default programs that have not necessarily been compiled yet
+    std::unordered_map<std::string, int> _defaultPrograms;
 };
 
 // end of shaders group
@@ -307,10 +307,13 @@ bool GLProgramState::init(GLProgram* glprogram)
         _attributes[attrib.first] = value;
     }
 
+    // the values keep pointers to their callbacks: the vector must not grow once they are set
+    _uniforms.reserve(_glprogram->_userUniforms.size());
     for(auto &uniform : _glprogram->_userUniforms) {
         UniformValue value(&uniform.second, _glprogram);
-        _uniforms[uniform.second.location] = value;
-        _uniformsByName[uniform.first] = uniform.second.location;
+        _uniformsByName[uniform.first] = (int)_uniforms.size();
+        _uniformsByLocation[uniform.second.location] = (int)_uniforms.size();
+        _uniforms.push_back(value);
     }
 
     return true;
@@ -320,6 +323,8 @@ void GLProgramState::resetGLProgram()
 {
     CC_SAFE_RELEASE(_glprogram);
     _uniforms.clear();
+    _uniformsByName.clear();
+    _uniformsByLocation.clear();
     _attributes.clear();
     // first texture is GL_TEXTURE1
     _textureUnitIndex = 1;
@@ -339,9 +344,9 @@ void GLProgramState::applyGLProgram(const Mat4& modelView)
     CCASSERT(_glprogram, "invalid glprogram");
     if(_uniformAttributeValueDirty)
     {
-        for(auto& uniformLocation : _uniformsByName)
+        for(auto& uniformIndex : _uniformsByName)
         {
-            _uniforms[uniformLocation.second]._uniform = _glprogram->getUniform(uniformLocation.first);
+            _uniforms[uniformIndex.second]._uniform = _glprogram->getUniform(uniformIndex.first);
         }
         
         _vertexAttribsFlags = 0;
@@ -377,8 +382,9 @@ void GLProgramState::applyAttributes(bool applyAttribFlags)
 void GLProgramState::applyUniforms()
 {
     // set uniforms
+    // unchanged values are skipped by the uniform cache of the GLProgram
     for(auto& uniform : _uniforms) {
-        uniform.second.apply();
+        uniform.apply();
     }
 }
 
@@ -394,9 +400,9 @@ void GLProgramState::setGLProgram(GLProgram *glprogram)
 
 UniformValue* GLProgramState::getUniformValue(GLint uniformLocation)
 {
-    const auto itr = _uniforms.find(uniformLocation);
-    if (itr != _uniforms.end())
-        return &itr->second;
+    const auto itr = _uniformsByLocation.find(uniformLocation);
+    if (itr != _uniformsByLocation.end())
+        return &_uniforms[itr->second];
     return nullptr;
 }
 
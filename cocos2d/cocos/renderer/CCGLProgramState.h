@@ -26,6 +26,7 @@ THE SOFTWARE.
 #define __CCGLPROGRAMSTATE_H__
 
 #include <unordered_map>
+#include <vector>
 
 #include "base/ccTypes.h"
 #include "base/CCVector.h"
@@ -209,8 +210,11 @@ protected:
     UniformValue* getUniformValue(GLint uniformLocation);
     
     bool _uniformAttributeValueDirty;
-    std::unordered_map<std::string, GLint> _uniformsByName;
-    std::unordered_map<GLint, UniformValue> _uniforms;
+    // index in _uniforms of each uniform, by name and by location
+    std::unordered_map<std::string, int> _uniformsByName;
+    std::unordered_map<GLint, int> _uniformsByLocation;
+    // flat, so that applyUniforms() doesn't walk a hash table on every material switch
+    std::vector<UniformValue> _uniforms;
     std::unordered_map<std::string, VertexAttribValue> _attributes;
     std::unordered_map<std::string, int> _boundTextureUnits;
 
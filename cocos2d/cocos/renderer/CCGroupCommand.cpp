@@ -30,6 +30,8 @@
 NS_CC_BEGIN
 
 GroupCommandManager::GroupCommandManager()
+: _nextGroupID(1)
+, _highWaterMark(0)
 {
 
 }
@@ -42,52 +44,58 @@ GroupCommandManager::~GroupCommandManager()
 bool GroupCommandManager::init()
 {
     //0 is the default render group
-    _groupMapping[0] = true;
+    _nextGroupID = 1;
     return true;
 }
 
 int GroupCommandManager::getGroupID()
 {
-    //Reuse old id
-    for(auto it = _groupMapping.begin(); it != _groupMapping.end(); ++it)
+    std::lock_guard<std::mutex> lock(_groupMappingMutex);
+
+    auto renderer = Director::getInstance()->getRenderer();
+    int newID = _nextGroupID++;
+    //Reuse the queues of the previous frames, only create them when the high water mark is exceeded
+    if (newID >= renderer->getRenderQueueCount())
     {
-        if(!it->second)
-        {
-            _groupMapping[it->first] = true;
-            return it->first;
-        }
+        renderer->createRenderQueue();
     }
-
-    //Create new ID
-//    int newID = _groupMapping.size();
-    int newID = Director::getInstance()->getRenderer()->createRenderQueue();
-    _groupMapping[newID] = true;
+    _highWaterMark = std::max(_highWaterMark, newID);
 
     return newID;
 }
 
+bool GroupCommandManager::isGroupIDValid(int groupID) const
+{
+    // the render queues may be growing from another thread of a parallel visit
+    std::lock_guard<std::mutex> lock(_groupMappingMutex);
+    return groupID >= 0 && groupID < _nextGroupID;
+}
+
 void GroupCommandManager::releaseGroupID(int groupID)
 {
-    _groupMapping[groupID] = false;
+    // the queue may already have been handed out again in this frame
+}
+
+void GroupCommandManager::reset()
+{
+    _nextGroupID = 1;
 }
 
 GroupCommand::GroupCommand()
 {
     _type = RenderCommand::Type::GROUP_COMMAND;
-    _renderQueueID = Director::getInstance()->getRenderer()->getGroupCommandManager()->getGroupID();
+    // the render queue is taken by init(), every frame
+    _renderQueueID = -1;
 }
 
 void GroupCommand::init(float globalOrder)
 {
     _globalOrder = globalOrder;
-    auto manager = Director::getInstance()->getRenderer()->getGroupCommandManager();
-    manager->releaseGroupID(_renderQueueID);
-    _renderQueueID = manager->getGroupID();
+    _renderQueueID = Director::getInstance()->getRenderer()->getGroupCommandManager()->getGroupID();
 }
 
 GroupCommand::~GroupCommand()
 {
-    Director::getInstance()->getRenderer()->getGroupCommandManager()->releaseGroupID(_renderQueueID);
 }
 
 NS_CC_END
@@ -26,7 +26,7 @@
 #ifndef _CC_GROUPCOMMAND_H_
 #define _CC_GROUPCOMMAND_H_
 
-#include <unordered_map>
+#include <mutex>
 
 #include "base/CCRef.h"
 #include "CCRenderCommand.h"
@@ -34,18 +34,37 @@
 
 NS_CC_BEGIN
 
+/** Hands out the render queues of the group commands.
+ The queues are allocated from a frame arena: a queue ID is only valid until the end of the frame it was
+ requested in, and the Renderer reuses the queues, and their capacity, in the following frames.
+ */
 class GroupCommandManager : public Ref
 {
 public:
+    /** returns the ID of a render queue that is free until the end of the frame */
     int getGroupID();
+    /** IDs are recycled at the end of the frame, so this does nothing. Kept for compatibility */
     void releaseGroupID(int groupID);
 
+    /** number of render queues requested in the current frame, besides the default one */
+    int getGroupCount() const { return _nextGroupID - 1; }
+    /** maximum number of render queues requested in a frame */
+    int getHighWaterMark() const { return _highWaterMark; }
+    /** returns true if the render queue was handed out in the current frame, or is the default one */
+    bool isGroupIDValid(int groupID) const;
+
 protected:
     friend class Renderer;
     GroupCommandManager();
     ~GroupCommandManager();
     bool init();
-    std::unordered_map<int, bool> _groupMapping;
+    // called by the Renderer when the frame has been rendered
+    void reset();
+
+    int _nextGroupID;
+    int _highWaterMark;
+    // group commands may be initialized from the threads of a parallel visit
+    mutable std::mutex _groupMappingMutex;
 };
 
 class GroupCommand : public RenderCommand
@@ -54,6 +73,7 @@ public:
     GroupCommand();
     ~GroupCommand();
     
+    /** Must be called every frame before the command is added: it takes a new render queue for the frame */
     void init(float depth);
 
     inline int getRenderQueueID() const {return _renderQueueID;}
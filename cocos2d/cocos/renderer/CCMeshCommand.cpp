@@ -43,17 +43,17 @@ NS_CC_BEGIN
 
 MeshCommand::MeshCommand()
 : _textureID(0)
-, _blendType(BlendFunc::DISABLE)
 , _glProgramState(nullptr)
-, _cullFaceEnabled(false)
-, _cullFace(GL_BACK)
-, _depthTestEnabled(false)
-, _depthWriteEnabled(false)
+, _blendType(BlendFunc::DISABLE)
 , _displayColor(1.0f, 1.0f, 1.0f, 1.0f)
 , _matrixPalette(nullptr)
 , _matrixPaletteSize(0)
 , _materialID(0)
 , _vao(0)
+, _cullFaceEnabled(false)
+, _cullFace(GL_BACK)
+, _depthTestEnabled(false)
+, _depthWriteEnabled(false)
 {
     _type = RenderCommand::Type::MESH_COMMAND;
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
@@ -109,6 +109,11 @@ void MeshCommand::setDepthWriteEnabled(bool enable)
     _depthWriteEnabled = enable;
 }
 
+bool MeshCommand::isOpaque() const
+{
+    return _blendType.src == GL_ONE && _blendType.dst == GL_ZERO && _depthTestEnabled && _depthWriteEnabled;
+}
+
 void MeshCommand::setDisplayColor(const Vec4& color)
 {
     _displayColor = color;
@@ -73,6 +73,18 @@ public:
     void genMaterialID(GLuint texID, void* glProgramState, void* mesh, const BlendFunc& blend);
     
     uint32_t getMaterialID() const { return _materialID; }
+
+    /** Returns true if the mesh is drawn without blending, with depth test and depth write enabled.
+     The Renderer may reorder consecutive opaque meshes to reduce state changes.
+     @since v3.3
+     */
+    bool isOpaque() const;
+
+    GLuint getTextureID() const { return _textureID; }
+    GLProgramState* getGLProgramState() const { return _glProgramState; }
+    GLuint getVertexBuffer() const { return _vertexBuffer; }
+    /** Returns the Z of the mesh origin in eye space, used to draw opaque meshes front to back */
+    float getDepth() const { return _mv.m[14]; }
     
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
     void listenRendererRecreated(EventCustom* event);
@@ -0,0 +1,286 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderCapture.h"
+
+#include <stdio.h>
+
+#include "renderer/CCRenderer.h"
+#include "renderer/CCQuadCommand.h"
+#include "renderer/CCGroupCommand.h"
+#include "renderer/CCMeshCommand.h"
+#include "renderer/CCGLProgramState.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace {
+
+template <typename T>
+void writeValue(FILE* fp, const T& value)
+{
+    fwrite(&value, sizeof(T), 1, fp);
+}
+
+class CaptureReader
+{
+public:
+    CaptureReader(const unsigned char* bytes, ssize_t size) : _bytes(bytes), _size(size), _offset(0), _failed(false) {}
+
+    template <typename T>
+    T read()
+    {
+        T value = T();
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    void readBytes(void* dst, ssize_t size)
+    {
+        if (_failed || size > _size - _offset)
+        {
+            _failed = true;
+            return;
+        }
+        memcpy(dst, _bytes + _offset, size);
+        _offset += size;
+    }
+
+    void fail() { _failed = true; }
+    ssize_t remaining() const { return _size - _offset; }
+    bool failed() const { return _failed; }
+
+private:
+    const unsigned char* _bytes;
+    ssize_t _size;
+    ssize_t _offset;
+    bool _failed;
+};
+
+} // namespace
+
+void RenderCapture::captureRenderQueues(const std::deque<RenderQueue>& renderGroups)
+{
+    queues.clear();
+
+    std::vector<int> capturedIndices(renderGroups.size(), -1);
+    captureRenderQueue(renderGroups, 0, capturedIndices);
+}
+
+int RenderCapture::captureRenderQueue(const std::deque<RenderQueue>& renderGroups, int renderQueueID, std::vector<int>& capturedIndices)
+{
+    if (capturedIndices[renderQueueID] >= 0)
+        return capturedIndices[renderQueueID];
+
+    int index = (int)queues.size();
+    capturedIndices[renderQueueID] = index;
+    queues.push_back(Queue());
+
+    const RenderQueue& renderQueue = renderGroups[renderQueueID];
+    ssize_t size = renderQueue.size();
+    for (ssize_t i = 0; i < size; ++i)
+    {
+        auto renderCommand = renderQueue[i];
+
+        Command command;
+        command.type = renderCommand->getType();
+        command.globalOrder = renderCommand->getGlobalOrder();
+        command.materialID = 0;
+        command.textureID = 0;
+        command.programID = 0;
+        command.blendFunc = BlendFunc::DISABLE;
+        command.queueIndex = -1;
+
+        if (command.type == RenderCommand::Type::QUAD_COMMAND)
+        {
+            auto cmd = static_cast<QuadCommand*>(renderCommand);
+            command.materialID = cmd->getMaterialID();
+            command.textureID = cmd->getTextureID();
+            command.programID = cmd->getGLProgramState()->getGLProgram()->getProgram();
+            command.blendFunc = cmd->getBlendType();
+            command.modelView = cmd->getModelView();
+            command.quads.assign(cmd->getQuads(), cmd->getQuads() + cmd->getQuadCount());
+        }
+        else if (command.type == RenderCommand::Type::GROUP_COMMAND)
+        {
+            // queues are captured depth first, `queues` may grow here
+            int groupIndex = captureRenderQueue(renderGroups, static_cast<GroupCommand*>(renderCommand)->getRenderQueueID(), capturedIndices);
+            command.queueIndex = groupIndex;
+        }
+        else if (command.type == RenderCommand::Type::MESH_COMMAND)
+        {
+            command.materialID = static_cast<MeshCommand*>(renderCommand)->getMaterialID();
+        }
+
+        queues[index].push_back(command);
+    }
+
+    return index;
+}
+
+bool RenderCapture::saveToFile(const std::string& filename) const
+{
+    FILE* fp = fopen(filename.c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("RenderCapture: cannot open %s for writing", filename.c_str());
+        return false;
+    }
+
+    writeValue(fp, MAGIC);
+    writeValue(fp, VERSION);
+    writeValue(fp, (uint32_t)queues.size());
+
+    for (const auto& queue : queues)
+    {
+        writeValue(fp, (uint32_t)queue.size());
+        for (const auto& command : queue)
+        {
+            writeValue(fp, (uint8_t)command.type);
+            writeValue(fp, command.globalOrder);
+            writeValue(fp, command.materialID);
+            writeValue(fp, (uint32_t)command.textureID);
+            writeValue(fp, (uint32_t)command.programID);
+            writeValue(fp, (uint32_t)command.blendFunc.src);
+            writeValue(fp, (uint32_t)command.blendFunc.dst);
+            fwrite(command.modelView.m, sizeof(float), 16, fp);
+            writeValue(fp, (int32_t)command.queueIndex);
+            writeValue(fp, (uint32_t)command.quads.size());
+            if (!command.quads.empty())
+            {
+                fwrite(command.quads.data(), sizeof(V3F_C4B_T2F_Quad), command.quads.size(), fp);
+            }
+        }
+    }
+
+    bool ret = (ferror(fp) == 0);
+    fclose(fp);
+    return ret;
+}
+
+bool RenderCapture::initWithFile(const std::string& filename)
+{
+    queues.clear();
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    if (data.isNull())
+    {
+        CCLOG("RenderCapture: cannot read %s", filename.c_str());
+        return false;
+    }
+
+    CaptureReader reader(data.getBytes(), data.getSize());
+    if (reader.read<uint32_t>() != MAGIC || reader.read<uint32_t>() != VERSION)
+    {
+        CCLOG("RenderCapture: %s is not a render capture, or was saved by another version", filename.c_str());
+        return false;
+    }
+
+    uint32_t queueCount = reader.read<uint32_t>();
+    for (uint32_t q = 0; q < queueCount && !reader.failed(); ++q)
+    {
+        uint32_t commandCount = reader.read<uint32_t>();
+        queues.push_back(Queue());
+        Queue& queue = queues.back();
+
+        for (uint32_t c = 0; c < commandCount && !reader.failed(); ++c)
+        {
+            Command command;
+            command.type = (RenderCommand::Type)reader.read<uint8_t>();
+            command.globalOrder = reader.read<float>();
+            command.materialID = reader.read<uint32_t>();
+            command.textureID = reader.read<uint32_t>();
+            command.programID = reader.read<uint32_t>();
+            command.blendFunc.src = reader.read<uint32_t>();
+            command.blendFunc.dst = reader.read<uint32_t>();
+            reader.readBytes(command.modelView.m, sizeof(float) * 16);
+            command.queueIndex = reader.read<int32_t>();
+
+            uint32_t quadCount = reader.read<uint32_t>();
+            if ((ssize_t)quadCount * (ssize_t)sizeof(V3F_C4B_T2F_Quad) > reader.remaining())
+            {
+                reader.fail();
+                break;
+            }
+            command.quads.resize(quadCount);
+            if (quadCount > 0)
+            {
+                reader.readBytes(command.quads.data(), sizeof(V3F_C4B_T2F_Quad) * quadCount);
+            }
+
+            queue.push_back(command);
+        }
+    }
+
+    // group commands must point to an existing queue
+    for (const auto& queue : queues)
+    {
+        for (const auto& command : queue)
+        {
+            if (command.type == RenderCommand::Type::GROUP_COMMAND &&
+                (command.queueIndex <= 0 || command.queueIndex >= (int)queues.size()))
+            {
+                reader.fail();
+            }
+        }
+    }
+
+    if (reader.failed() || queues.empty())
+    {
+        CCLOG("RenderCapture: %s is truncated or corrupted", filename.c_str());
+        queues.clear();
+        return false;
+    }
+
+    return true;
+}
+
+ssize_t RenderCapture::getCommandCount(RenderCommand::Type type) const
+{
+    ssize_t count = 0;
+    for (const auto& queue : queues)
+    {
+        for (const auto& command : queue)
+        {
+            if (command.type == type)
+                ++count;
+        }
+    }
+    return count;
+}
+
+ssize_t RenderCapture::getQuadCount() const
+{
+    ssize_t count = 0;
+    for (const auto& queue : queues)
+    {
+        for (const auto& command : queue)
+        {
+            count += command.quads.size();
+        }
+    }
+    return count;
+}
+
+NS_CC_END
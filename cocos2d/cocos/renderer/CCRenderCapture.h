@@ -0,0 +1,93 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RENDER_CAPTURE_H__
+#define __CC_RENDER_CAPTURE_H__
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base/ccTypes.h"
+#include "renderer/CCRenderCommand.h"
+
+NS_CC_BEGIN
+
+class RenderQueue;
+
+/** @brief The render queues of one frame, as they were before being sorted and rendered.
+
+ Captures are saved with Renderer::captureNextFrame() and can be replayed offline with tools/render-replay,
+ to measure batching and sorting changes on real frames without running the game.
+
+ Only what matters for sorting and batching is kept:
+ - quad commands: global order, material ID, texture, program, blend function, model view and quads
+ - group commands: global order and the captured queue they point to
+ - custom, batch and mesh commands: global order (and material ID for meshes), as markers
+ 
+ Files are written in the native byte order.
+ @since v3.3
+ */
+class CC_DLL RenderCapture
+{
+public:
+    /** "CCRF" */
+    static const uint32_t MAGIC = 0x46524343;
+    static const uint32_t VERSION = 1;
+
+    struct Command
+    {
+        RenderCommand::Type type;
+        float globalOrder;
+        uint32_t materialID;
+        GLuint textureID;
+        GLuint programID;
+        BlendFunc blendFunc;
+        Mat4 modelView;
+        /** index in `queues` of the queue of a group command */
+        int queueIndex;
+        std::vector<V3F_C4B_T2F_Quad> quads;
+    };
+    typedef std::vector<Command> Queue;
+
+    /** Copies the queues that can be reached from the default render queue. `queues[0]` is the default one */
+    void captureRenderQueues(const std::deque<RenderQueue>& renderGroups);
+
+    bool saveToFile(const std::string& filename) const;
+    bool initWithFile(const std::string& filename);
+
+    /** Returns the number of commands of the given type, in all the queues */
+    ssize_t getCommandCount(RenderCommand::Type type) const;
+    /** Returns the number of quads, in all the queues */
+    ssize_t getQuadCount() const;
+
+    std::vector<Queue> queues;
+
+protected:
+    int captureRenderQueue(const std::deque<RenderQueue>& renderGroups, int renderQueueID, std::vector<int>& capturedIndices);
+};
+
+NS_CC_END
+
+#endif //__CC_RENDER_CAPTURE_H__
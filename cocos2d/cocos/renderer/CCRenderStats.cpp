@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderStats.h"
+
+#include <stdio.h>
+
+NS_CC_BEGIN
+
+void RenderStats::reset()
+{
+    for (int i = 0; i < COMMAND_TYPE_COUNT; ++i)
+    {
+        commandCounts[i] = 0;
+    }
+    for (int i = 0; i < (int)FlushReason::COUNT; ++i)
+    {
+        flushCounts[i] = 0;
+    }
+    quadCount = 0;
+    opaqueMeshCount = 0;
+    drawCalls = 0;
+    drawnVertices = 0;
+    materialSwitches = 0;
+    bytesUploaded = 0;
+    uniformCallsIssued = 0;
+    uniformCallsSkipped = 0;
+    renderQueuesUsed = 0;
+    renderQueuesHighWaterMark = 0;
+    renderQueuesCapacity = 0;
+    visitTime = 0;
+    sortTime = 0;
+    renderTime = 0;
+}
+
+std::string RenderStats::getDescription() const
+{
+    char buf[1024];
+    snprintf(buf, sizeof(buf),
+             "draw calls: %ld, vertices: %ld, material switches: %ld, uploaded: %.2f KB\n"
+             "commands: quad %ld (%ld quads), group %ld, custom %ld, batch %ld, mesh %ld (%ld opaque)\n"
+             "flushes: vbo full %ld, custom %ld, batch %ld, group %ld, mesh %ld, end of frame %ld\n"
+             "uniforms: issued %ld, skipped %ld\n"
+             "render queues: used %ld, high water mark %ld, capacity %ld commands\n"
+             "time: visit %.3f ms, sort %.3f ms, render %.3f ms\n",
+             (long)drawCalls, (long)drawnVertices, (long)materialSwitches, bytesUploaded / 1024.0f,
+             (long)commandCounts[(int)RenderCommand::Type::QUAD_COMMAND], (long)quadCount,
+             (long)commandCounts[(int)RenderCommand::Type::GROUP_COMMAND],
+             (long)commandCounts[(int)RenderCommand::Type::CUSTOM_COMMAND],
+             (long)commandCounts[(int)RenderCommand::Type::BATCH_COMMAND],
+             (long)commandCounts[(int)RenderCommand::Type::MESH_COMMAND], (long)opaqueMeshCount,
+             (long)flushCounts[(int)FlushReason::VBO_FULL],
+             (long)flushCounts[(int)FlushReason::CUSTOM_COMMAND],
+             (long)flushCounts[(int)FlushReason::BATCH_COMMAND],
+             (long)flushCounts[(int)FlushReason::GROUP_COMMAND],
+             (long)flushCounts[(int)FlushReason::MESH_COMMAND],
+             (long)flushCounts[(int)FlushReason::END_OF_FRAME],
+             (long)uniformCallsIssued, (long)uniformCallsSkipped,
+             (long)renderQueuesUsed, (long)renderQueuesHighWaterMark, (long)renderQueuesCapacity,
+             visitTime, sortTime, renderTime);
+    return buf;
+}
+
+NS_CC_END
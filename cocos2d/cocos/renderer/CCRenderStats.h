@@ -0,0 +1,114 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RENDER_STATS_H__
+#define __CC_RENDER_STATS_H__
+
+#include <string>
+
+#include "base/CCPlatformMacros.h"
+#include "renderer/CCRenderCommand.h"
+
+NS_CC_BEGIN
+
+/** @brief Statistics of one frame rendered by the Renderer.
+
+ Use it to find out where batching breaks: each flush of the batched quads is counted with the reason
+ that triggered it.
+ @see Renderer::getFrameStats()
+ @since v3.3
+ */
+struct CC_DLL RenderStats
+{
+    /** Why the batched quads were drawn */
+    enum class FlushReason
+    {
+        /** the quads didn't fit in the vertex buffer */
+        VBO_FULL,
+        /** a CustomCommand was found */
+        CUSTOM_COMMAND,
+        /** a BatchCommand was found */
+        BATCH_COMMAND,
+        /** a GroupCommand was found */
+        GROUP_COMMAND,
+        /** a MeshCommand was found */
+        MESH_COMMAND,
+        /** the frame ended */
+        END_OF_FRAME,
+
+        COUNT
+    };
+
+    static const int COMMAND_TYPE_COUNT = (int)RenderCommand::Type::MESH_COMMAND + 1;
+
+    RenderStats() { reset(); }
+
+    void reset();
+
+    /** Returns a human readable description of the stats */
+    std::string getDescription() const;
+
+    /** Returns the number of commands of the given type */
+    ssize_t getCommandCount(RenderCommand::Type type) const { return commandCounts[(int)type]; }
+    /** Returns how many times the batched quads were drawn for the given reason */
+    ssize_t getFlushCount(FlushReason reason) const { return flushCounts[(int)reason]; }
+
+    /** number of rendered commands, by RenderCommand::Type */
+    ssize_t commandCounts[COMMAND_TYPE_COUNT];
+    /** number of opaque MeshCommands that were sorted by state before being drawn */
+    ssize_t opaqueMeshCount;
+    /** number of quads of the QuadCommands */
+    ssize_t quadCount;
+    /** number of draw calls, same as Renderer::getDrawnBatches() */
+    ssize_t drawCalls;
+    /** number of drawn vertices, same as Renderer::getDrawnVertices() */
+    ssize_t drawnVertices;
+    /** number of times a QuadCommand or MeshCommand material was applied */
+    ssize_t materialSwitches;
+    /** number of times the batched quads were drawn, by FlushReason */
+    ssize_t flushCounts[(int)FlushReason::COUNT];
+    /** number of bytes of vertex data uploaded for the batched quads */
+    ssize_t bytesUploaded;
+    /** number of glUniform calls issued by the GLPrograms */
+    ssize_t uniformCallsIssued;
+    /** number of glUniform calls skipped by the GLPrograms because the value didn't change */
+    ssize_t uniformCallsSkipped;
+    /** number of render queues used by group commands */
+    ssize_t renderQueuesUsed;
+    /** maximum number of render queues used by group commands in a frame */
+    ssize_t renderQueuesHighWaterMark;
+    /** number of commands all the render queues can hold without allocating */
+    ssize_t renderQueuesCapacity;
+
+    /** time spent visiting the scene graph, in milliseconds */
+    float visitTime;
+    /** time spent sorting the render queues, in milliseconds */
+    float sortTime;
+    /** time spent in Renderer::render(), sorting included, in milliseconds */
+    float renderTime;
+};
+
+NS_CC_END
+
+#endif //__CC_RENDER_STATS_H__
@@ -25,14 +25,19 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <chrono>
 
 #include "renderer/CCQuadCommand.h"
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCMeshCommand.h"
+#include "renderer/CCRenderCapture.h"
+#include "renderer/CCDebugDrawBatch.h"
+#include "base/CCThreadPool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
@@ -47,6 +52,21 @@ static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
     return a->getGlobalOrder() < b->getGlobalOrder();
 }
 
+// sorts opaque meshes by program, texture and vertex buffer, then front to back
+static bool compareOpaqueMeshCommand(MeshCommand* a, MeshCommand* b)
+{
+    GLuint programA = a->getGLProgramState()->getGLProgram()->getProgram();
+    GLuint programB = b->getGLProgramState()->getGLProgram()->getProgram();
+    if (programA != programB)
+        return programA < programB;
+    if (a->getTextureID() != b->getTextureID())
+        return a->getTextureID() < b->getTextureID();
+    if (a->getVertexBuffer() != b->getVertexBuffer())
+        return a->getVertexBuffer() < b->getVertexBuffer();
+    // the camera looks down -Z: the greater the Z, the nearer the mesh
+    return a->getDepth() > b->getDepth();
+}
+
 // queue
 
 void RenderQueue::push_back(RenderCommand* command)
@@ -98,6 +118,11 @@ void RenderQueue::clear()
     _queuePosZ.clear();
 }
 
+ssize_t RenderQueue::capacity() const
+{
+    return _queueNegZ.capacity() + _queue0.capacity() + _queuePosZ.capacity();
+}
+
 //
 //
 //
@@ -112,11 +137,19 @@ Renderer::Renderer()
 ,_numQuads(0)
 ,_glViewAssigned(false)
 ,_isRendering(false)
+,_isRecording(false)
+,_visitThreadPool(nullptr)
+,_mainThreadSlice(0)
+,_visitCount(0)
+,_visitSlices(0)
+,_visitRange(nullptr)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
 {
     _groupCommandManager = new GroupCommandManager();
+    // created here rather than on first use, as parallel visit threads may draw to it
+    _debugDrawBatch = new DebugDrawBatch();
     
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
@@ -127,6 +160,7 @@ Renderer::Renderer()
 
 Renderer::~Renderer()
 {
+    CC_SAFE_DELETE(_debugDrawBatch);
     _renderGroups.clear();
     _groupCommandManager->release();
     
@@ -243,6 +277,13 @@ void Renderer::mapBuffers()
 
 void Renderer::addCommand(RenderCommand* command)
 {
+    if (_isRecording)
+    {
+        auto buffer = getCommandBuffer();
+        addCommand(command, buffer->groupStack.top());
+        return;
+    }
+
     int renderQueue =_commandGroupStack.top();
     addCommand(command, renderQueue);
 }
@@ -252,25 +293,142 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+
+    if (_isRecording)
+    {
+        getCommandBuffer()->commands.push_back(std::make_pair(renderQueue, command));
+        return;
+    }
+
     _renderGroups[renderQueue].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(_groupCommandManager->isGroupIDValid(renderQueueID), "Invalid render queue, was GroupCommand::init() called?");
+
+    if (_isRecording)
+    {
+        getCommandBuffer()->groupStack.push(renderQueueID);
+        return;
+    }
+
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+
+    if (_isRecording)
+    {
+        getCommandBuffer()->groupStack.pop();
+        return;
+    }
+
     _commandGroupStack.pop();
 }
 
+Renderer::CommandBuffer* Renderer::getCommandBuffer()
+{
+    // only the workers running a slice and the thread that started the visit add commands while recording.
+    // The pool is kept from the start of the visit: ThreadPool::getInstance() takes a lock
+    int worker = _visitThreadPool->getWorkerIndex();
+    int slice = (worker < 0) ? _mainThreadSlice : _workerSlices[worker];
+    CCASSERT(slice >= 0 && slice < _visitSlices, "Commands can only be added from the threads of a parallel visit");
+    return &_commandBuffers[slice];
+}
+
+void Renderer::visitInParallel(ssize_t count, const std::function<void(ssize_t first, ssize_t last)>& visitRange)
+{
+    auto pool = ThreadPool::getInstance();
+    int workers = std::min(pool->getThreadCount(), CC_PARALLEL_VISIT_MAX_THREADS);
+    int slices = (int)std::min((ssize_t)workers + 1, count / CC_PARALLEL_VISIT_MIN_NODES_PER_THREAD);
+
+    // nested parallel visits are visited by the thread that reached them
+    if (_isRecording || slices <= 1)
+    {
+        visitRange(0, count);
+        return;
+    }
+
+    if ((int)_commandBuffers.size() < slices)
+        _commandBuffers.resize(slices);
+    _workerSlices.assign(pool->getThreadCount(), -1);
+
+    for (int i = 0; i < slices; ++i)
+    {
+        auto& buffer = _commandBuffers[i];
+        buffer.commands.clear();
+        while (!buffer.groupStack.empty())
+            buffer.groupStack.pop();
+        buffer.groupStack.push(_commandGroupStack.top());
+    }
+
+    _visitCount = count;
+    _visitRange = &visitRange;
+    _visitSlices = slices;
+    _visitThreadPool = pool;
+    _isRecording = true;
+
+    // submitting the tasks publishes the state above to the workers
+    std::vector<ThreadPool::Task> tasks;
+    tasks.reserve(slices - 1);
+    for (int i = 1; i < slices; ++i)
+    {
+        tasks.push_back(pool->submit([this, pool, i](){
+            // a worker only writes its own entry
+            _workerSlices[pool->getWorkerIndex()] = i;
+            visitSlice(i);
+        }, ThreadPool::Priority::HIGH));
+    }
+
+    _mainThreadSlice = 0;
+    visitSlice(0);
+
+    // the slices that no worker took yet, because they are busy with other tasks, are visited here
+    for (int i = 1; i < slices; ++i)
+    {
+        auto& task = tasks[i - 1];
+        if (task.cancel())
+        {
+            _mainThreadSlice = i;
+            visitSlice(i);
+        }
+        else
+        {
+            task.wait();
+        }
+    }
+    _mainThreadSlice = 0;
+    _isRecording = false;
+    _visitThreadPool = nullptr;
+
+    // merge in slice order so that the result matches a serial visit
+    for (int i = 0; i < slices; ++i)
+    {
+        auto& buffer = _commandBuffers[i];
+        CCASSERT(buffer.groupStack.size() == 1, "Unbalanced pushGroup/popGroup in parallel visit");
+        for (const auto& entry : buffer.commands)
+            _renderGroups[entry.first].push_back(entry.second);
+        buffer.commands.clear();
+    }
+
+    _visitSlices = 0;
+    _visitRange = nullptr;
+}
+
+void Renderer::visitSlice(int slice)
+{
+    ssize_t first = _visitCount * slice / _visitSlices;
+    ssize_t last = _visitCount * (slice + 1) / _visitSlices;
+    (*_visitRange)(first, last);
+}
+
 int Renderer::createRenderQueue()
 {
-    RenderQueue newRenderQueue;
-    _renderGroups.push_back(newRenderQueue);
+    _renderGroups.emplace_back();
     return (int)_renderGroups.size() - 1;
 }
 
@@ -282,6 +440,7 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
     {
         auto command = queue[index];
         auto commandType = command->getType();
+        ++_stats.commandCounts[(int)commandType];
         if(RenderCommand::Type::QUAD_COMMAND == commandType)
         {
             flush3D();
@@ -292,6 +451,7 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
                 CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() < VBO_SIZE, "VBO is not big enough for quad data, please break the quad data down or use customized render command");
                 
                 //Draw batched quads if VBO is full
+                recordFlush(RenderStats::FlushReason::VBO_FULL);
                 drawBatchedQuads();
             }
             
@@ -301,40 +461,61 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
             convertToWorldCoordinates(_quads + _numQuads, cmd->getQuadCount(), cmd->getModelView());
             
             _numQuads += cmd->getQuadCount();
+            _stats.quadCount += cmd->getQuadCount();
 
         }
         else if(RenderCommand::Type::GROUP_COMMAND == commandType)
         {
+            recordFlush(RenderStats::FlushReason::GROUP_COMMAND);
             flush();
             int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
             visitRenderQueue(_renderGroups[renderQueueID]);
         }
         else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
         {
+            recordFlush(RenderStats::FlushReason::CUSTOM_COMMAND);
             flush();
             auto cmd = static_cast<CustomCommand*>(command);
             cmd->execute();
         }
         else if(RenderCommand::Type::BATCH_COMMAND == commandType)
         {
+            recordFlush(RenderStats::FlushReason::BATCH_COMMAND);
             flush();
             auto cmd = static_cast<BatchCommand*>(command);
             cmd->execute();
         }
         else if (RenderCommand::Type::MESH_COMMAND == commandType)
         {
+            recordFlush(RenderStats::FlushReason::MESH_COMMAND);
             flush2D();
             auto cmd = static_cast<MeshCommand*>(command);
-            if (_lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
+            if (cmd->isOpaque())
             {
-                flush3D();
-                cmd->preBatchDraw();
-                cmd->batchDraw();
-                _lastBatchedMeshCommand = cmd;
+                // Opaque meshes test and write the depth, so the depth buffer resolves their visibility and a run
+                // of them can be drawn in any order: sort it by state to share it between the draws, then front to back.
+                _opaqueMeshCommands.clear();
+                ssize_t end = index;
+                for (; end < size; ++end)
+                {
+                    auto next = queue[end];
+                    if (next->getType() != RenderCommand::Type::MESH_COMMAND || !static_cast<MeshCommand*>(next)->isOpaque())
+                        break;
+                    _opaqueMeshCommands.push_back(static_cast<MeshCommand*>(next));
+                }
+
+                if (_opaqueMeshCommands.size() > 1)
+                    std::stable_sort(std::begin(_opaqueMeshCommands), std::end(_opaqueMeshCommands), compareOpaqueMeshCommand);
+
+                _stats.commandCounts[(int)commandType] += end - index - 1;
+                _stats.opaqueMeshCount += end - index;
+                for (auto mesh : _opaqueMeshCommands)
+                    drawMeshCommand(mesh);
+                index = end - 1;
             }
             else
             {
-                cmd->batchDraw();
+                drawMeshCommand(cmd);
             }
         }
         else
@@ -344,6 +525,22 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
     }
 }
 
+void Renderer::drawMeshCommand(MeshCommand* cmd)
+{
+    if (_lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
+    {
+        flush3D();
+        ++_stats.materialSwitches;
+        cmd->preBatchDraw();
+        cmd->batchDraw();
+        _lastBatchedMeshCommand = cmd;
+    }
+    else
+    {
+        cmd->batchDraw();
+    }
+}
+
 void Renderer::render()
 {
     //Uncomment this once everything is rendered by new renderer
@@ -354,18 +551,56 @@ void Renderer::render()
     
     if (_glViewAssigned)
     {
+        auto renderStart = std::chrono::high_resolution_clock::now();
+
         // cleanup
         _drawnBatches = _drawnVertices = 0;
 
+        if (!_captureFilename.empty())
+        {
+            RenderCapture capture;
+            capture.captureRenderQueues(_renderGroups);
+            if (capture.saveToFile(_captureFilename))
+                CCLOG("Renderer: frame captured to %s", _captureFilename.c_str());
+            _captureFilename.clear();
+        }
+
         //Process render commands
         //1. Sort render commands based on ID
+        // the capture is not part of the sort time
+        auto sortStart = std::chrono::high_resolution_clock::now();
         for (auto &renderqueue : _renderGroups)
         {
             renderqueue.sort();
         }
+        auto sortEnd = std::chrono::high_resolution_clock::now();
+
         visitRenderQueue(_renderGroups[0]);
+        recordFlush(RenderStats::FlushReason::END_OF_FRAME);
         flush();
+
+        _debugDrawBatch->flush();
+
+        auto renderEnd = std::chrono::high_resolution_clock::now();
+        _stats.sortTime = std::chrono::duration_cast<std::chrono::microseconds>(sortEnd - sortStart).count() / 1000.0f;
+        _stats.renderTime = std::chrono::duration_cast<std::chrono::microseconds>(renderEnd - renderStart).count() / 1000.0f;
+        _stats.drawCalls = _drawnBatches;
+        _stats.drawnVertices = _drawnVertices;
+        // counted since the end of the previous frame
+        _stats.uniformCallsIssued = GLProgram::getUniformCallsIssued();
+        _stats.uniformCallsSkipped = GLProgram::getUniformCallsSkipped();
+        _stats.renderQueuesUsed = _groupCommandManager->getGroupCount();
+        _stats.renderQueuesHighWaterMark = _groupCommandManager->getHighWaterMark();
+        for (const auto& renderqueue : _renderGroups)
+        {
+            _stats.renderQueuesCapacity += renderqueue.capacity();
+        }
+        GLProgram::resetUniformCallCounters();
+        _frameStats = _stats;
+        _stats.reset();
     }
+    // the shapes of a frame that was not drawn must not pile up
+    _debugDrawBatch->clear();
     clean();
     _isRendering = false;
 }
@@ -383,6 +618,9 @@ void Renderer::clean()
         _renderGroups[j].clear();
     }
 
+    // The queues keep their capacity and are handed out again next frame
+    _groupCommandManager->reset();
+
     // Clear batch quad commands
     _batchedQuadCommands.clear();
     _numQuads = 0;
@@ -469,6 +707,8 @@ void Renderer::drawBatchedQuads()
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     }
 
+    _stats.bytesUploaded += sizeof(_quads[0]) * _numQuads;
+
     //Start drawing verties in batch
     for(const auto& cmd : _batchedQuadCommands)
     {
@@ -489,6 +729,7 @@ void Renderer::drawBatchedQuads()
             //Use new material
             cmd->useMaterial();
             _lastMaterialID = newMaterialID;
+            ++_stats.materialSwitches;
         }
 
         quadsToDraw += cmd->getQuadCount();
@@ -26,12 +26,16 @@
 #ifndef __CC_RENDERER_H_
 #define __CC_RENDERER_H_
 
+#include <deque>
 #include <vector>
 #include <stack>
+#include <string>
+#include <functional>
 
 #include "base/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCRenderStats.h"
 #include "CCGL.h"
 
 NS_CC_BEGIN
@@ -39,6 +43,8 @@ NS_CC_BEGIN
 class EventListenerCustom;
 class QuadCommand;
 class MeshCommand;
+class DebugDrawBatch;
+class ThreadPool;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
@@ -53,6 +59,8 @@ public:
     void sort();
     RenderCommand* operator[](ssize_t index) const;
     void clear();
+    /** number of commands the queue can hold without allocating */
+    ssize_t capacity() const;
 
 protected:
     std::vector<RenderCommand*> _queueNegZ;
@@ -96,15 +104,37 @@ public:
     /** Pops a group from the render queue */
     void popGroup();
 
-    /** Creates a render queue and returns its Id */
+    /** Calls `visitRange` on contiguous slices of [0, count) from the workers of the shared ThreadPool, and waits until all of them are done.
+     The main thread visits the first slice, and the slices that no worker started by the time it is done.
+     While the slices are being visited, the commands added for each slice are recorded in a buffer owned by that slice.
+     The buffers are then merged in slice order, so the render queues end up exactly as if [0, count) had been visited serially.
+     Falls back to a serial visit when there are too few elements or when it is called from inside another parallel visit.
+     @see Node::setParallelVisitEnabled
+     @since v3.3
+     */
+    void visitInParallel(ssize_t count, const std::function<void(ssize_t first, ssize_t last)>& visitRange);
+
+    /** Creates a render queue and returns its Id. Use GroupCommandManager::getGroupID(), which can be called during parallel visits */
     int createRenderQueue();
 
+    /** Returns the number of render queues, the default one included. Queues are reused from frame to frame */
+    int getRenderQueueCount() const { return (int)_renderGroups.size(); }
+
+    /** Returns the render queue with the given Id. Used by nodes that capture the commands of their children */
+    inline RenderQueue& getRenderQueue(int renderQueueID) { return _renderGroups[renderQueueID]; }
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
     /** Cleans all `RenderCommand`s in the queue */
     void clean();
 
+    /** Saves the render queues of the next rendered frame to `filename`, before they are sorted.
+     @see RenderCapture
+     @since v3.3
+     */
+    void captureNextFrame(const std::string& filename) { _captureFilename = filename; }
+
     /* returns the number of drawn batches in the last frame */
     ssize_t getDrawnBatches() const { return _drawnBatches; }
     /* RenderCommands (except) QuadCommand should update this value */
@@ -116,6 +146,20 @@ public:
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
+    /** Returns the statistics of the last rendered frame
+     @since v3.3
+     */
+    const RenderStats& getFrameStats() const { return _frameStats; }
+    /** Sets the time spent visiting the scene graph of the frame being built, in milliseconds. Called by the Director
+     @since v3.3
+     */
+    void setFrameVisitTime(float milliseconds) { _stats.visitTime = milliseconds; }
+
+    /** Returns the debug draw batch. The shapes added to it are drawn on top of the frame being built
+     @since v3.3
+     */
+    DebugDrawBatch* getDebugDrawBatch() const { return _debugDrawBatch; }
+
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
@@ -139,15 +183,32 @@ protected:
     
     void visitRenderQueue(const RenderQueue& queue);
 
+    void drawMeshCommand(MeshCommand* cmd);
+
+    // counts a flush if there are quads to draw
+    inline void recordFlush(RenderStats::FlushReason reason) { if (_numQuads > 0) ++_stats.flushCounts[(int)reason]; }
+
     void convertToWorldCoordinates(V3F_C4B_T2F_Quad* quads, ssize_t quantity, const Mat4& modelView);
 
+    struct CommandBuffer
+    {
+        std::stack<int> groupStack;
+        std::vector<std::pair<int, RenderCommand*>> commands;
+    };
+
+    /* returns the buffer of the slice the calling thread is visiting */
+    CommandBuffer* getCommandBuffer();
+    void visitSlice(int slice);
+
     std::stack<int> _commandGroupStack;
     
-    std::vector<RenderQueue> _renderGroups;
+    // a deque, so that the queues never move when one is added during a parallel visit
+    std::deque<RenderQueue> _renderGroups;
 
     uint32_t _lastMaterialID;
 
     MeshCommand*              _lastBatchedMeshCommand;
+    std::vector<MeshCommand*> _opaqueMeshCommands;
     std::vector<QuadCommand*> _batchedQuadCommands;
 
     V3F_C4B_T2F_Quad _quads[VBO_SIZE];
@@ -162,10 +223,29 @@ protected:
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    // stats of the frame being rendered, and of the last rendered one
+    RenderStats _stats;
+    RenderStats _frameStats;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     GroupCommandManager* _groupCommandManager;
+
+    DebugDrawBatch* _debugDrawBatch;
+
+    // render capture of the next frame, if not empty
+    std::string _captureFilename;
+
+    // parallel visit
+    std::vector<CommandBuffer> _commandBuffers;
+    bool _isRecording;
+    ThreadPool* _visitThreadPool;
+    // slice visited by each worker of the ThreadPool, and by the thread that started the visit
+    std::vector<int> _workerSlices;
+    int _mainThreadSlice;
+    ssize_t _visitCount;
+    int _visitSlices;
+    const std::function<void(ssize_t, ssize_t)>* _visitRange;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
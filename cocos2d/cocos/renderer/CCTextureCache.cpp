@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include <list>
 
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCDynamicAtlas.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -59,11 +60,7 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
-, _needQuit(false)
-, _asyncRefCount(0)
+: _dynamicAtlas(nullptr)
 {
 }
 
@@ -74,7 +71,9 @@ TextureCache::~TextureCache()
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    CC_SAFE_DELETE(_dynamicAtlas);
+
+    waitForQuit();
 }
 
 void TextureCache::destroyInstance()
@@ -111,160 +110,65 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
-    // lazy init
-    if (_asyncStructQueue == nullptr)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new deque<ImageInfo*>();        
-
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
+    // generate async struct
+    AsyncStruct *data = new AsyncStruct(fullpath, callback);
 
-        _needQuit = false;
+    // a file already being loaded isn't loaded twice, its texture is in the cache by the time this request is served
+    auto pending = std::find_if(_asyncStructQueue.begin(), _asyncStructQueue.end(), [&fullpath](AsyncStruct* ptr)->bool{ return ptr->filename == fullpath; });
+    if (pending == _asyncStructQueue.end())
+    {
+        data->task = ThreadPool::getInstance()->submit([data](){
+            // generate image
+            Image *image = new Image();
+            if (image->initWithImageFileThreadSafe(data->filename))
+            {
+                data->image = image;
+            }
+            else
+            {
+                image->release();
+                CCLOG("can not load %s", data->filename.c_str());
+            }
+        });
+        data->task.then([this, data](){
+            data->loaded = true;
+            addImageAsyncCallBack();
+        });
     }
-
-    if (0 == _asyncRefCount)
+    else
     {
-        Director::getInstance()->getScheduler()->schedule(schedule_selector(TextureCache::addImageAsyncCallBack), this, 0, false);
+        data->loaded = true;
     }
 
-    ++_asyncRefCount;
-
-    // generate async struct
-    AsyncStruct *data = new AsyncStruct(fullpath, callback);
-
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
-
-    _sleepCondition.notify_one();
+    _asyncStructQueue.push_back(data);
 }
 
 void TextureCache::unbindImageAsync(const std::string& filename)
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    for (auto asyncStruct : _asyncStructQueue)
     {
-        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
-        auto found = std::find_if(_imageInfoQueue->begin(), _imageInfoQueue->end(), [&fullpath](ImageInfo* ptr)->bool{ return ptr->asyncStruct->filename == fullpath; });
-        if (found != _imageInfoQueue->end())
+        if (asyncStruct->filename == fullpath)
         {
-            (*found)->asyncStruct->callback = nullptr;
+            asyncStruct->callback = nullptr;
         }
     }
-    _imageInfoMutex.unlock();
 }
 
 void TextureCache::unbindAllImageAsync()
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
-    {
-        std::for_each(_imageInfoQueue->begin(), _imageInfoQueue->end(), [](ImageInfo* ptr) { ptr->asyncStruct->callback = nullptr; });
-    }
-    _imageInfoMutex.unlock();
-}
-
-void TextureCache::loadImage()
-{
-    AsyncStruct *asyncStruct = nullptr;
-
-    while (true)
-    {
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
-        {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
-                break;
-            }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
-            }
-        }
-        else
-        {
-            asyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
-
-        Image *image = nullptr;
-        bool generateImage = false;
-
-        auto it = _textures.find(asyncStruct->filename);
-        if( it == _textures.end() )
-        {
-           _imageInfoMutex.lock();
-           ImageInfo *imageInfo;
-           size_t pos = 0;
-           size_t infoSize = _imageInfoQueue->size();
-           for (; pos < infoSize; pos++)
-           {
-               imageInfo = (*_imageInfoQueue)[pos];
-               if(imageInfo->asyncStruct->filename.compare(asyncStruct->filename) == 0)
-                   break;
-           }
-           _imageInfoMutex.unlock();
-           if(infoSize == 0 || pos == infoSize)
-               generateImage = true;
-        }
-
-        if (generateImage)
-        {
-            const std::string& filename = asyncStruct->filename;
-            // generate image      
-            image = new Image();
-            if (image && !image->initWithImageFileThreadSafe(filename))
-            {
-                CC_SAFE_RELEASE(image);
-                CCLOG("can not load %s", filename.c_str());
-                continue;
-            }
-        }    
-
-        // generate image info
-        ImageInfo *imageInfo = new ImageInfo();
-        imageInfo->asyncStruct = asyncStruct;
-        imageInfo->image = image;
-
-        // put the image info into the queue
-        _imageInfoMutex.lock();
-        _imageInfoQueue->push_back(imageInfo);
-        _imageInfoMutex.unlock();
-    }
-    
-	if(_asyncStructQueue != nullptr)
-    {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
-    }
+    std::for_each(_asyncStructQueue.begin(), _asyncStructQueue.end(), [](AsyncStruct* ptr) { ptr->callback = nullptr; });
 }
 
-void TextureCache::addImageAsyncCallBack(float dt)
+void TextureCache::addImageAsyncCallBack()
 {
-    // the image is generated in loading thread
-    std::deque<ImageInfo*> *imagesQueue = _imageInfoQueue;
-
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
+    // callbacks are called in the order of the requests
+    while (!_asyncStructQueue.empty() && _asyncStructQueue.front()->loaded)
     {
-        _imageInfoMutex.unlock();
-    }
-    else
-    {
-        ImageInfo *imageInfo = imagesQueue->front();
-        imagesQueue->pop_front();
-        _imageInfoMutex.unlock();
+        AsyncStruct *asyncStruct = _asyncStructQueue.front();
+        _asyncStructQueue.pop_front();
 
-        AsyncStruct *asyncStruct = imageInfo->asyncStruct;
-        Image *image = imageInfo->image;
+        Image *image = asyncStruct->image;
 
         const std::string& filename = asyncStruct->filename;
 
@@ -293,7 +197,8 @@ void TextureCache::addImageAsyncCallBack(float dt)
                 texture = it->second;
         }
         
-        if (asyncStruct->callback)
+        // as before, a file that failed to load doesn't call back
+        if (asyncStruct->callback && texture)
         {
             asyncStruct->callback(texture);
         }
@@ -303,13 +208,6 @@ void TextureCache::addImageAsyncCallBack(float dt)
             image->release();
         }       
         delete asyncStruct;
-        delete imageInfo;
-
-        --_asyncRefCount;
-        if (0 == _asyncRefCount)
-        {
-            Director::getInstance()->getScheduler()->unschedule(schedule_selector(TextureCache::addImageAsyncCallBack), this);
-        }
     }
 }
 
@@ -364,6 +262,68 @@ Texture2D * TextureCache::addImage(const std::string &path)
     return texture;
 }
 
+Texture2D* TextureCache::addImageToDynamicAtlas(const std::string &path, Rect* rect)
+{
+    CCASSERT(rect != nullptr, "TextureCache: rect MUST not be nil");
+
+    Texture2D* texture = nullptr;
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
+    if (fullpath.size() == 0)
+    {
+        return nullptr;
+    }
+
+    // images that are already loaded as standalone textures are not duplicated into a page
+    if (_dynamicAtlas && _textures.find(fullpath) == _textures.end())
+    {
+        texture = _dynamicAtlas->getTextureForKey(fullpath, rect);
+        if (texture)
+        {
+            return texture;
+        }
+
+        Image* image = new (std::nothrow) Image();
+        if (image && image->initWithImageFile(fullpath))
+        {
+            texture = _dynamicAtlas->addImage(image, fullpath, rect);
+            if (texture == nullptr)
+            {
+                // the atlas can't hold it, don't decode the file twice
+                texture = new (std::nothrow) Texture2D();
+                if (texture && texture->initWithImage(image))
+                {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+                    VolatileTextureMgr::addImageTexture(texture, fullpath);
+#endif
+                    _textures.insert( std::make_pair(fullpath, texture) );
+                }
+                else
+                {
+                    CC_SAFE_RELEASE_NULL(texture);
+                }
+            }
+            else
+            {
+                CC_SAFE_RELEASE(image);
+                return texture;
+            }
+        }
+        CC_SAFE_RELEASE(image);
+    }
+
+    if (texture == nullptr)
+    {
+        texture = addImage(fullpath);
+    }
+
+    if (texture)
+    {
+        rect->origin = Vec2::ZERO;
+        rect->size = texture->getContentSizeInPixels();
+    }
+    return texture;
+}
+
 Texture2D* TextureCache::addImage(Image *image, const std::string &key)
 {
     CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
@@ -447,6 +407,11 @@ void TextureCache::removeAllTextures()
         (it->second)->release();
     }
     _textures.clear();
+
+    if (_dynamicAtlas)
+    {
+        _dynamicAtlas->removeAllPages();
+    }
 }
 
 void TextureCache::removeUnusedTextures()
@@ -463,6 +428,11 @@ void TextureCache::removeUnusedTextures()
         }
 
     }
+
+    if (_dynamicAtlas)
+    {
+        _dynamicAtlas->removeUnusedPages();
+    }
 }
 
 void TextureCache::removeTexture(Texture2D* texture)
@@ -521,12 +491,30 @@ void TextureCache::reloadAllTextures()
 // #endif
 }
 
+void TextureCache::setDynamicAtlasEnabled(bool enabled)
+{
+    if (enabled && _dynamicAtlas == nullptr)
+    {
+        _dynamicAtlas = new (std::nothrow) DynamicAtlas();
+    }
+    else if (!enabled)
+    {
+        // sprites that use a page keep it alive
+        CC_SAFE_DELETE(_dynamicAtlas);
+    }
+}
+
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // drop the pending requests, wait for the images being loaded
+    for (auto asyncStruct : _asyncStructQueue)
+    {
+        asyncStruct->task.cancel();
+        asyncStruct->task.wait();
+        CC_SAFE_RELEASE(asyncStruct->image);
+        delete asyncStruct;
+    }
+    _asyncStructQueue.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -563,6 +551,11 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (_dynamicAtlas)
+    {
+        buffer += _dynamicAtlas->getInfo();
+    }
+
     return buffer;
 }
 
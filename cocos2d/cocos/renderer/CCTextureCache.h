@@ -30,14 +30,13 @@ THE SOFTWARE.
 
 #include <string>
 #include <mutex>
-#include <thread>
-#include <condition_variable>
-#include <queue>
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <functional>
 
 #include "base/CCRef.h"
+#include "base/CCThreadPool.h"
 #include "renderer/CCTexture2D.h"
 #include "platform/CCImage.h"
 
@@ -48,6 +47,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class DynamicAtlas;
+
 /**
  * @addtogroup textures
  * @{
@@ -112,7 +113,7 @@ public:
 
     /* Returns a Texture2D object given a file image
     * If the file image was not previously loaded, it will create a new Texture2D object and it will return it.
-    * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
+    * Otherwise it will load a texture on the engine's ThreadPool, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
     * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
     * Supported image extensions: .png, .jpg
     * @since v0.8
@@ -185,47 +186,50 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** Enables or disables packing small images into shared pages at runtime.
+    * When enabled, Sprites created with Sprite::createInDynamicAtlas() share textures and can be batched
+    * together by the renderer. Other sprites keep standalone textures. Disabling it releases the pages that are not in use.
+    * Disabled by default.
+    * @since v3.3
+    */
+    void setDynamicAtlasEnabled(bool enabled);
+    bool isDynamicAtlasEnabled() const { return _dynamicAtlas != nullptr; }
+
+    /** Returns a Texture2D object that contains the image, and sets `rect` to the region of the image in pixels.
+    * If the dynamic atlas is enabled and the image is small enough, the texture is a page shared with other images.
+    * Otherwise it behaves like addImage() and `rect` covers the whole texture.
+    * @since v3.3
+    */
+    Texture2D* addImageToDynamicAtlas(const std::string &filepath, Rect* rect);
+
     //wait for texture cahe to quit befor destroy instance
     //called by director, please do not called outside
     void waitForQuit();
 
 private:
-    void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void addImageAsyncCallBack();
 
 public:
     struct AsyncStruct
     {
     public:
-        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f) {}
+        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f), image(nullptr), loaded(false) {}
 
         std::string filename;
         std::function<void(Texture2D*)> callback;
+        // written by the loading task, read once it is done
+        Image* image;
+        bool loaded;
+        ThreadPool::Task task;
     };
 
 protected:
-    typedef struct _ImageInfo
-    {
-        AsyncStruct *asyncStruct;
-        Image        *image;
-    } ImageInfo;
-    
-    std::thread* _loadingThread;
-
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::deque<ImageInfo*>* _imageInfoQueue;
-
-    std::mutex _asyncStructQueueMutex;
-    std::mutex _imageInfoMutex;
-
-    std::mutex _sleepMutex;
-    std::condition_variable _sleepCondition;
-
-    bool _needQuit;
-
-    int _asyncRefCount;
+    // requests in the order they were made, only touched by the cocos2d thread
+    std::deque<AsyncStruct*> _asyncStructQueue;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    DynamicAtlas* _dynamicAtlas;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
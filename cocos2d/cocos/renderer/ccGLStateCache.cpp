@@ -27,6 +27,9 @@ THE SOFTWARE.
 
 #include "renderer/ccGLStateCache.h"
 
+#include <vector>
+#include <algorithm>
+
 #include "renderer/CCGLProgram.h"
 #include "base/CCDirector.h"
 #include "base/ccConfig.h"
@@ -42,6 +45,13 @@ namespace
     static GLuint s_currentProjectionMatrix = -1;
     static uint32_t s_attributeFlags = 0;  // 32 attributes max
 
+    struct ScissorState
+    {
+        GLboolean enabled;
+        GLint box[4];
+    };
+    static std::vector<ScissorState> s_scissorStack;
+
 #if CC_ENABLE_GL_STATE_CACHE
 
     static GLuint    s_currentShaderProgram = -1;
@@ -213,6 +223,45 @@ void bindVAO(GLuint vaoId)
     }
 }
 
+void pushScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    ScissorState state;
+    state.enabled = glIsEnabled(GL_SCISSOR_TEST);
+    glGetIntegerv(GL_SCISSOR_BOX, state.box);
+    s_scissorStack.push_back(state);
+
+    // nested clipping nodes only draw inside all of their ancestors
+    if (state.enabled)
+    {
+        GLint right = std::min(x + width, state.box[0] + state.box[2]);
+        GLint top = std::min(y + height, state.box[1] + state.box[3]);
+        x = std::max(x, state.box[0]);
+        y = std::max(y, state.box[1]);
+        width = std::max(right - x, 0);
+        height = std::max(top - y, 0);
+    }
+    else
+    {
+        glEnable(GL_SCISSOR_TEST);
+    }
+    glScissor(x, y, width, height);
+}
+
+void popScissor()
+{
+    CCASSERT(!s_scissorStack.empty(), "popScissor() without pushScissor()");
+    const ScissorState& state = s_scissorStack.back();
+    if (state.enabled)
+    {
+        glScissor(state.box[0], state.box[1], state.box[2], state.box[3]);
+    }
+    else
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    s_scissorStack.pop_back();
+}
+
 // GL Vertex Attrib functions
 
 void enableVertexAttribs(uint32_t flags)
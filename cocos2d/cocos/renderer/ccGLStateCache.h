@@ -143,6 +143,18 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/** Enables the scissor test and restricts drawing to the intersection of the given window rectangle,
+ in pixels, with the current scissor box. Used by the clipping nodes for rectangular clipping.
+ Each call must be balanced by a call to popScissor().
+ @since v3.3
+ */
+void CC_DLL pushScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/** Restores the scissor test and box that were set before the matching pushScissor().
+ @since v3.3
+ */
+void CC_DLL popScissor();
+
 // end of shaders group
 /// @}
 
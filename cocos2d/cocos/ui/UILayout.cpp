@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "CCGLView.h"
 #include "2d/CCSprite.h"
 #include "base/CCEventFocus.h"
+#include "base/ccUtils.h"
+#include "renderer/ccGLStateCache.h"
 
 
 NS_CC_BEGIN
@@ -246,8 +248,7 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    director->pushModelViewTransform(_modelViewTransform);
     //Add group command
 
     _groupCommand.init(_globalZOrder);
@@ -255,15 +256,24 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
     
     renderer->pushGroup(_groupCommand.getRenderQueueID());
     
+    // the stencil is a rectangle: when it stays axis aligned on screen, a scissor box is enough
+    bool useScissor = checkStencilScissorClipping();
+
     _beforeVisitCmdStencil.init(_globalZOrder);
-    _beforeVisitCmdStencil.func = CC_CALLBACK_0(Layout::onBeforeVisitStencil, this);
+    if (useScissor)
+        _beforeVisitCmdStencil.func = CC_CALLBACK_0(Layout::onBeforeVisitStencilScissor, this);
+    else
+        _beforeVisitCmdStencil.func = CC_CALLBACK_0(Layout::onBeforeVisitStencil, this);
     renderer->addCommand(&_beforeVisitCmdStencil);
     
-    _clippingStencil->visit(renderer, _modelViewTransform, flags);
-    
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(Layout::onAfterDrawStencil, this);
-    renderer->addCommand(&_afterDrawStencilCmd);
+    if (!useScissor)
+    {
+        _clippingStencil->visit(renderer, _modelViewTransform, flags);
+        
+        _afterDrawStencilCmd.init(_globalZOrder);
+        _afterDrawStencilCmd.func = CC_CALLBACK_0(Layout::onAfterDrawStencil, this);
+        renderer->addCommand(&_afterDrawStencilCmd);
+    }
     
     int i = 0;      // used by _children
     int j = 0;      // used by _protectedChildren
@@ -310,12 +320,15 @@ void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransfor
 
     
     _afterVisitCmdStencil.init(_globalZOrder);
-    _afterVisitCmdStencil.func = CC_CALLBACK_0(Layout::onAfterVisitStencil, this);
+    if (useScissor)
+        _afterVisitCmdStencil.func = CC_CALLBACK_0(Layout::onAfterVisitStencilScissor, this);
+    else
+        _afterVisitCmdStencil.func = CC_CALLBACK_0(Layout::onAfterVisitStencil, this);
     renderer->addCommand(&_afterVisitCmdStencil);
     
     renderer->popGroup();
     
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->popModelViewTransform();
 }
     
 void Layout::onBeforeVisitStencil()
@@ -384,17 +397,41 @@ void Layout::onAfterVisitStencil()
     s_layer--;
 }
     
+bool Layout::checkStencilScissorClipping()
+{
+    Rect rect;
+    if (!_clippingStencil || !_clippingStencil->isAxisAlignedRect(&rect))
+        return false;
+
+    _stencilScissorTransform = _modelViewTransform * _clippingStencil->getNodeToParentTransform();
+    if (!utils::isAxisAligned(_stencilScissorTransform))
+        return false;
+
+    _stencilScissorRect = rect;
+    return true;
+}
+
+void Layout::onBeforeVisitStencilScissor()
+{
+    Rect rect = utils::getWindowRect(_stencilScissorTransform, _stencilScissorRect);
+    GL::pushScissor((GLint)rect.origin.x, (GLint)rect.origin.y, (GLsizei)rect.size.width, (GLsizei)rect.size.height);
+}
+
+void Layout::onAfterVisitStencilScissor()
+{
+    GL::popScissor();
+}
+
 void Layout::onBeforeVisitScissor()
 {
-    Rect clippingRect = getClippingRect();
-    glEnable(GL_SCISSOR_TEST);
-    auto glview = Director::getInstance()->getOpenGLView();
-    glview->setScissorInPoints(clippingRect.origin.x, clippingRect.origin.y, clippingRect.size.width, clippingRect.size.height);
+    // the clipping rect is in world space, pushScissor intersects it with the enclosing clipping nodes
+    Rect rect = utils::getWindowRect(Mat4::IDENTITY, getClippingRect());
+    GL::pushScissor((GLint)rect.origin.x, (GLint)rect.origin.y, (GLsizei)rect.size.width, (GLsizei)rect.size.height);
 }
 
 void Layout::onAfterVisitScissor()
 {
-    glDisable(GL_SCISSOR_TEST);
+    GL::popScissor();
 }
     
 void Layout::scissorClippingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
@@ -346,6 +346,10 @@ protected:
     
     void onBeforeVisitScissor();
     void onAfterVisitScissor();
+    // stencil clipping of an axis aligned layout is done with a scissor box
+    bool checkStencilScissorClipping();
+    void onBeforeVisitStencilScissor();
+    void onAfterVisitStencilScissor();
     void updateBackGroundImageColor();
     void updateBackGroundImageOpacity();
     void updateBackGroundImageRGBA();
@@ -501,6 +505,8 @@ protected:
     GLubyte _backGroundImageOpacity;
     
     GLint _mask_layer_le;
+    Rect _stencilScissorRect;
+    Mat4 _stencilScissorTransform;
     GroupCommand _groupCommand;
     CustomCommand _beforeVisitCmdStencil;
     CustomCommand _afterDrawStencilCmd;
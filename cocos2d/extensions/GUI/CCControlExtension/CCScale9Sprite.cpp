@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "base/CCPlatformMacros.h"
 #include "2d/CCSprite.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "renderer/CCRenderer.h"
 
 NS_CC_EXT_BEGIN
 
@@ -47,6 +48,8 @@ Scale9Sprite::Scale9Sprite()
 , _bottom(nullptr)
 , _bottomRight(nullptr)
 , _opacityModifyRGB(false)
+, _singleCommandEnabled(false)
+, _quadsDirty(true)
 , _insetLeft(0)
 , _insetTop(0)
 , _insetRight(0)
@@ -369,6 +372,7 @@ bool Scale9Sprite::updateWithBatchNode(SpriteBatchNode* batchnode, const Rect& o
 
     this->setContentSize(rect.size);
     this->addChild(_scale9Image);
+    this->updateSlicesVisibility();
     
     if (_spritesGenerated)
     {
@@ -385,6 +389,49 @@ void Scale9Sprite::setContentSize(const Size &size)
 {
     Node::setContentSize(size);
     this->_positionsAreDirty = true;
+    this->_quadsDirty = true;
+}
+
+void Scale9Sprite::setSingleCommandEnabled(bool enabled)
+{
+    if (_singleCommandEnabled == enabled)
+    {
+        return;
+    }
+    _singleCommandEnabled = enabled;
+    _quadsDirty = true;
+    updateSlicesVisibility();
+}
+
+void Scale9Sprite::updateSlicesVisibility()
+{
+    Sprite* slices[9] = { _bottomLeft, _bottom, _bottomRight, _left, _centre, _right, _topLeft, _top, _topRight };
+    for (auto slice : slices)
+    {
+        if (slice)
+        {
+            slice->setVisible(!_singleCommandEnabled);
+        }
+    }
+    _quadsDirty = true;
+}
+
+void Scale9Sprite::updateQuads()
+{
+    // the quads of the slice sprites, moved into the space of this node
+    Sprite* slices[9] = { _bottomLeft, _bottom, _bottomRight, _left, _centre, _right, _topLeft, _top, _topRight };
+    for (int i = 0; i < 9; ++i)
+    {
+        V3F_C4B_T2F_Quad& quad = _quads[i];
+        quad = slices[i]->getQuad();
+
+        const Mat4& transform = slices[i]->getNodeToParentTransform();
+        transform.transformPoint(&quad.bl.vertices);
+        transform.transformPoint(&quad.br.vertices);
+        transform.transformPoint(&quad.tl.vertices);
+        transform.transformPoint(&quad.tr.vertices);
+    }
+    _quadsDirty = false;
 }
 
 void Scale9Sprite::updatePositions()
@@ -689,6 +736,7 @@ void Scale9Sprite::setOpacityModifyRGB(bool var)
     for(auto child : _scale9Image->getChildren()){
         child->setOpacityModifyRGB(_opacityModifyRGB);
     }
+    _quadsDirty = true;
 }
 
 bool Scale9Sprite::isOpacityModifyRGB() const
@@ -758,10 +806,27 @@ void Scale9Sprite::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     {
         this->updatePositions();
         this->_positionsAreDirty = false;
+        this->_quadsDirty = true;
     }
     Node::visit(renderer, parentTransform, parentFlags);
 }
 
+void Scale9Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
+{
+    if (!_singleCommandEnabled || !_centre)
+    {
+        return;
+    }
+
+    if (_quadsDirty)
+    {
+        updateQuads();
+    }
+
+    _quadCommand.init(_globalZOrder, _centre->getTexture()->getName(), _centre->getGLProgramState(), _centre->getBlendFunc(), _quads, 9, transform);
+    renderer->addCommand(&_quadCommand);
+}
+
 void Scale9Sprite::setColor(const Color3B& color)
 {
     if (!_scale9Image)
@@ -774,6 +839,7 @@ void Scale9Sprite::setColor(const Color3B& color)
     for(auto child : _scale9Image->getChildren()){
         child->setColor(color);
     }
+    _quadsDirty = true;
 }
 
 void Scale9Sprite::setOpacity(GLubyte opacity)
@@ -787,6 +853,7 @@ void Scale9Sprite::setOpacity(GLubyte opacity)
     for(auto child : _scale9Image->getChildren()){
         child->setOpacity(opacity);
     }
+    _quadsDirty = true;
 }
 
 void Scale9Sprite::updateDisplayedColor(const cocos2d::Color3B &parentColor)
@@ -800,6 +867,7 @@ void Scale9Sprite::updateDisplayedColor(const cocos2d::Color3B &parentColor)
     for(auto child : _scale9Image->getChildren()){
         child->updateDisplayedColor(parentColor);
     }
+    _quadsDirty = true;
 }
 
 void Scale9Sprite::updateDisplayedOpacity(GLubyte parentOpacity)
@@ -813,6 +881,7 @@ void Scale9Sprite::updateDisplayedOpacity(GLubyte parentOpacity)
     for(auto child : _scale9Image->getChildren()){
         child->updateDisplayedOpacity(parentOpacity);
     }
+    _quadsDirty = true;
 }
 
 NS_CC_EXT_END
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteBatchNode.h"
+#include "renderer/CCQuadCommand.h"
 
 #include "../../ExtensionMacros.h"
 
@@ -255,6 +256,16 @@ public:
     virtual bool updateWithBatchNode(SpriteBatchNode* batchnode, const Rect& rect, bool rotated, const Rect& capInsets);
     virtual void setSpriteFrame(SpriteFrame * spriteFrame);
 
+    /**
+     * When enabled, the nine slices are drawn as the nine quads of a single QuadCommand instead of
+     * being visited as nine child sprites. The quads are only recomputed when the size, the cap insets,
+     * the sprite frame, the color or the opacity change.
+     * The slice sprites are kept, hidden, to compute the quads. Disabled by default.
+     * @since v3.3
+     */
+    void setSingleCommandEnabled(bool enabled);
+    bool isSingleCommandEnabled() const { return _singleCommandEnabled; }
+
     // overrides
     virtual void setContentSize(const Size & size) override;
     /**
@@ -262,6 +273,8 @@ public:
      * @lua NA
      */
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
+    virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
     virtual void setOpacityModifyRGB(bool bValue) override;
     virtual bool isOpacityModifyRGB(void) const override;
     virtual void setOpacity(GLubyte opacity) override;
@@ -272,6 +285,8 @@ public:
 protected:
     void updateCapInset();
     void updatePositions();
+    void updateSlicesVisibility();
+    void updateQuads();
 
     bool _spritesGenerated;
     Rect _spriteRect;
@@ -292,6 +307,12 @@ protected:
 
     bool _opacityModifyRGB;
 
+    // single command mode
+    bool _singleCommandEnabled;
+    bool _quadsDirty;
+    V3F_C4B_T2F_Quad _quads[9];
+    QuadCommand _quadCommand;
+
     /** Original sprite's size. */
     CC_SYNTHESIZE_READONLY(Size, _originalSize, OriginalSize);
     /** Prefered sprite's size. By default the prefered size is the original size. */
@@ -380,6 +380,7 @@ public:
      * @lua NA
      */
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
     /**
      * @js NA
      * @lua NA
@@ -226,6 +226,7 @@ public:
      * @lua NA
      */
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool isParallelVisitSupported() const override { return false; }
     
     using Node::addChild;
     virtual void addChild(Node * child, int zOrder, int tag) override;
@@ -0,0 +1,217 @@
+/****************************************************************************
+ Copyright (c) 2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/* render-replay: replays a frame saved with Renderer::captureNextFrame() through the Renderer,
+ to measure sorting and batching without running the game.
+
+ usage: render-replay <capture file> [frames]
+
+ Textures are replaced with 1x1 textures and programs with copies of the default sprite program, one per
+ captured texture and program, so the commands batch exactly like in the captured frame.
+ Custom, batch and mesh commands are replayed as empty custom commands: they only break the batches.
+ */
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+class Replayer
+{
+public:
+    explicit Replayer(RenderCapture& capture) : _capture(capture) {}
+
+    ~Replayer()
+    {
+        for (auto& it : _textures)
+            it.second->release();
+        for (auto& it : _programStates)
+            it.second->release();
+        CC_SAFE_RELEASE(_doNotBatchState);
+    }
+
+    void init()
+    {
+        static const unsigned char white[4] = { 255, 255, 255, 255 };
+
+        _doNotBatchState = GLProgramState::create(GLProgram::createWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColorAlphaTest_frag));
+        // a program state with uniforms is never batched
+        _doNotBatchState->setUniformFloat(GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE, 0.0f);
+        _doNotBatchState->retain();
+
+        _commands.resize(_capture.queues.size());
+        for (size_t q = 0; q < _capture.queues.size(); ++q)
+        {
+            for (auto& command : _capture.queues[q])
+            {
+                if (command.type == RenderCommand::Type::QUAD_COMMAND)
+                {
+                    if (_textures.find(command.textureID) == _textures.end())
+                    {
+                        auto texture = new (std::nothrow) Texture2D();
+                        texture->initWithData(white, sizeof(white), Texture2D::PixelFormat::RGBA8888, 1, 1, Size(1, 1));
+                        _textures[command.textureID] = texture;
+                    }
+                    if (command.materialID != QuadCommand::MATERIAL_ID_DO_NOT_BATCH && _programStates.find(command.programID) == _programStates.end())
+                    {
+                        auto state = GLProgramState::create(GLProgram::createWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColor_noMVP_frag));
+                        state->retain();
+                        _programStates[command.programID] = state;
+                    }
+                }
+
+                RenderCommand* renderCommand = nullptr;
+                switch (command.type)
+                {
+                    case RenderCommand::Type::QUAD_COMMAND:
+                        _quadCommands.push_back(std::unique_ptr<QuadCommand>(new QuadCommand()));
+                        renderCommand = _quadCommands.back().get();
+                        break;
+                    case RenderCommand::Type::GROUP_COMMAND:
+                        _groupCommands.push_back(std::unique_ptr<GroupCommand>(new GroupCommand()));
+                        renderCommand = _groupCommands.back().get();
+                        break;
+                    default:
+                        _customCommands.push_back(std::unique_ptr<CustomCommand>(new CustomCommand()));
+                        renderCommand = _customCommands.back().get();
+                        break;
+                }
+                _commands[q].push_back(renderCommand);
+            }
+        }
+    }
+
+    void addCommands(Renderer* renderer, int queueIndex = 0, int depth = 0)
+    {
+        // captures are loaded from disk: don't trust them to be acyclic
+        if (depth > MAX_GROUP_DEPTH)
+            return;
+
+        auto& queue = _capture.queues[queueIndex];
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            auto& command = queue[i];
+            auto renderCommand = _commands[queueIndex][i];
+
+            if (command.type == RenderCommand::Type::QUAD_COMMAND)
+            {
+                auto cmd = static_cast<QuadCommand*>(renderCommand);
+                auto state = (command.materialID == QuadCommand::MATERIAL_ID_DO_NOT_BATCH) ? _doNotBatchState : _programStates[command.programID];
+                cmd->init(command.globalOrder, _textures[command.textureID]->getName(), state, command.blendFunc,
+                          command.quads.data(), command.quads.size(), command.modelView);
+                renderer->addCommand(cmd);
+            }
+            else if (command.type == RenderCommand::Type::GROUP_COMMAND)
+            {
+                auto cmd = static_cast<GroupCommand*>(renderCommand);
+                cmd->init(command.globalOrder);
+                renderer->addCommand(cmd);
+                renderer->pushGroup(cmd->getRenderQueueID());
+                addCommands(renderer, command.queueIndex, depth + 1);
+                renderer->popGroup();
+            }
+            else
+            {
+                auto cmd = static_cast<CustomCommand*>(renderCommand);
+                cmd->init(command.globalOrder);
+                renderer->addCommand(cmd);
+            }
+        }
+    }
+
+private:
+    static const int MAX_GROUP_DEPTH = 64;
+
+    RenderCapture& _capture;
+    // the commands of each captured queue
+    std::vector<std::vector<RenderCommand*>> _commands;
+    std::vector<std::unique_ptr<QuadCommand>> _quadCommands;
+    std::vector<std::unique_ptr<GroupCommand>> _groupCommands;
+    std::vector<std::unique_ptr<CustomCommand>> _customCommands;
+    std::map<GLuint, Texture2D*> _textures;
+    std::map<GLuint, GLProgramState*> _programStates;
+    GLProgramState* _doNotBatchState = nullptr;
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <capture file> [frames]\n", argv[0]);
+        return 1;
+    }
+
+    int frames = (argc > 2) ? atoi(argv[2]) : 100;
+    if (frames <= 0)
+        frames = 1;
+
+    auto glview = GLView::createWithRect("render-replay", Rect(0, 0, 960, 640));
+    glfwHideWindow(glview->getWindow());
+    auto director = Director::getInstance();
+    director->setOpenGLView(glview);
+
+    RenderCapture capture;
+    if (!capture.initWithFile(argv[1]))
+    {
+        printf("cannot load %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("queues: %d, quad commands: %d, quads: %d, group commands: %d, custom: %d, batch: %d, mesh: %d\n",
+           (int)capture.queues.size(),
+           (int)capture.getCommandCount(RenderCommand::Type::QUAD_COMMAND),
+           (int)capture.getQuadCount(),
+           (int)capture.getCommandCount(RenderCommand::Type::GROUP_COMMAND),
+           (int)capture.getCommandCount(RenderCommand::Type::CUSTOM_COMMAND),
+           (int)capture.getCommandCount(RenderCommand::Type::BATCH_COMMAND),
+           (int)capture.getCommandCount(RenderCommand::Type::MESH_COMMAND));
+
+    auto renderer = director->getRenderer();
+    {
+        Replayer replayer(capture);
+        replayer.init();
+
+        double totalMs = 0;
+        for (int i = 0; i < frames; ++i)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            replayer.addCommands(renderer);
+            renderer->render();
+            glFinish();
+            auto end = std::chrono::high_resolution_clock::now();
+            totalMs += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+        }
+
+        printf("frames: %d, draw calls: %d, vertices: %d, average frame: %.3f ms\n",
+               frames, (int)renderer->getDrawnBatches(), (int)renderer->getDrawnVertices(), totalMs / frames);
+    }
+
+    director->end();
+    director->mainLoop();
+    return 0;
+}